@@ -0,0 +1,347 @@
+/*! \file Dual.h
+ *  \brief Forward mode automatic differentiation number
+ */
+
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <cmath>
+#include <iostream>
+#include "debug_tools.h"
+#include "numlib-config.h"
+
+namespace numlib{
+
+//! Non-deduced context for scalar operands of mixed Dual expressions
+template<class T>
+struct DualScalar
+{
+	typedef T type;
+};
+
+//! Forward mode automatic differentiation (dual) number
+/*!
+ *  Carries a value, x, together with its derivatives with respect to N
+ *  independent directions, dx/ds_k (k = 0,...,N-1). Arithmetic operators and
+ *  the common math functions are overloaded so that derivatives are
+ *  propagated exactly (to round-off) by the chain rule. Thus, code which is
+ *  templated on its numeric type (in lieu of Real) may be differentiated by
+ *  evaluating it with Dual arguments; e.g. a residual templated as
+ *
+ *     template<class S>
+ *     void eval(const linalg::Vector< S > & u, linalg::Vector< S > & r);
+ *
+ *  The tangents are stored contiguously, and all tangent loops have fixed
+ *  trip count N; thus, the compiler is free to unroll and vectorize them.
+ *  Evaluating with N > 1 amortizes the cost of the value computation over N
+ *  directional derivatives.
+ *
+ *  The math functions are defined in the numlib namespace, and are found by
+ *  argument dependent lookup; templated code should therefore call them
+ *  unqualified (e.g. sqrt(x) rather than std::sqrt(x)), with a using
+ *  declaration at function scope (e.g. using std::sqrt) to cover the
+ *  built-in types. Conversely, numlib code which is not templated on its
+ *  numeric type should qualify calls to the built-in functions (e.g.
+ *  std::sqrt), since the overloads defined here hide those of the global
+ *  namespace.
+ *
+ *  Scalar operands of mixed expressions are converted to T; thus, literals
+ *  of other types may be used directly, e.g. 2*u or pow(u, 2).
+ */
+template<class T, Size N>
+class Dual
+{
+public:
+
+	//! Constructs a constant equal to zero
+	Dual(): x(0)
+	{
+		for(Index k=0; k<N; ++k) dx[k] = T(0);
+	}
+
+	//! Constructs a constant (zero derivatives)
+	Dual(const T& x_): x(x_)
+	{
+		for(Index k=0; k<N; ++k) dx[k] = T(0);
+	}
+
+	//! Constructs an independent variable seeded in direction k
+	Dual(const T& x_, Index k_): x(x_)
+	{
+		ASSERT( k_ < N );
+		for(Index k=0; k<N; ++k) dx[k] = T(0);
+		dx[k_] = T(1);
+	}
+
+	//! Returns the value
+	T& value() { return x; }
+
+	//! Returns the value
+	const T& value() const { return x; }
+
+	//! Returns the derivative in direction k
+	T& derivative(Index k) { ASSERT( k < N ); return dx[k]; }
+
+	//! Returns the derivative in direction k
+	const T& derivative(Index k) const { ASSERT( k < N ); return dx[k]; }
+
+	//! Returns the number of directions
+	static Size directions() { return N; }
+
+	/* In-place arithmetic operators */
+
+	Dual& operator+=(const Dual& b)
+	{
+		x += b.x;
+		for(Index k=0; k<N; ++k) dx[k] += b.dx[k];
+		return *this;
+	}
+
+	Dual& operator-=(const Dual& b)
+	{
+		x -= b.x;
+		for(Index k=0; k<N; ++k) dx[k] -= b.dx[k];
+		return *this;
+	}
+
+	Dual& operator*=(const Dual& b)
+	{
+		for(Index k=0; k<N; ++k) dx[k] = dx[k]*b.x + x*b.dx[k];
+		x *= b.x;
+		return *this;
+	}
+
+	Dual& operator/=(const Dual& b)
+	{
+		const T inv = T(1)/b.x;
+		x *= inv;
+		for(Index k=0; k<N; ++k) dx[k] = (dx[k] - x*b.dx[k])*inv;
+		return *this;
+	}
+
+	Dual& operator+=(const T& c) { x += c; return *this; }
+
+	Dual& operator-=(const T& c) { x -= c; return *this; }
+
+	Dual& operator*=(const T& c)
+	{
+		x *= c;
+		for(Index k=0; k<N; ++k) dx[k] *= c;
+		return *this;
+	}
+
+	Dual& operator/=(const T& c)
+	{
+		const T inv = T(1)/c;
+		x *= inv;
+		for(Index k=0; k<N; ++k) dx[k] *= inv;
+		return *this;
+	}
+
+	//! Applies the chain rule, d[g(x)] = g'(x)*dx, with g(x) = gx
+	Dual chain(const T& gx, const T& dgx) const
+	{
+		Dual y(gx);
+		for(Index k=0; k<N; ++k) y.dx[k] = dgx*dx[k];
+		return y;
+	}
+
+private:
+
+	//! Value
+	T x;
+
+	//! Derivatives (tangents)
+	T dx[N];
+
+};
+
+/*------------------------------------------------------------------------*/
+/*                                                   ARITHMETIC OPERATORS */
+
+template<class T, Size N> inline
+Dual<T,N> operator+(const Dual<T,N>& a) { return a; }
+
+template<class T, Size N> inline
+Dual<T,N> operator-(const Dual<T,N>& a) { return a.chain(-a.value(), T(-1)); }
+
+template<class T, Size N> inline
+Dual<T,N> operator+(Dual<T,N> a, const Dual<T,N>& b) { return a += b; }
+
+template<class T, Size N> inline
+Dual<T,N> operator+(Dual<T,N> a, const typename DualScalar<T>::type& c)
+{ return a += c; }
+
+template<class T, Size N> inline
+Dual<T,N> operator+(const typename DualScalar<T>::type& c, Dual<T,N> a)
+{ return a += c; }
+
+template<class T, Size N> inline
+Dual<T,N> operator-(Dual<T,N> a, const Dual<T,N>& b) { return a -= b; }
+
+template<class T, Size N> inline
+Dual<T,N> operator-(Dual<T,N> a, const typename DualScalar<T>::type& c)
+{ return a -= c; }
+
+template<class T, Size N> inline
+Dual<T,N> operator-(const typename DualScalar<T>::type& c, const Dual<T,N>& a)
+{ return (-a) += c; }
+
+template<class T, Size N> inline
+Dual<T,N> operator*(Dual<T,N> a, const Dual<T,N>& b) { return a *= b; }
+
+template<class T, Size N> inline
+Dual<T,N> operator*(Dual<T,N> a, const typename DualScalar<T>::type& c)
+{ return a *= c; }
+
+template<class T, Size N> inline
+Dual<T,N> operator*(const typename DualScalar<T>::type& c, Dual<T,N> a)
+{ return a *= c; }
+
+template<class T, Size N> inline
+Dual<T,N> operator/(Dual<T,N> a, const Dual<T,N>& b) { return a /= b; }
+
+template<class T, Size N> inline
+Dual<T,N> operator/(Dual<T,N> a, const typename DualScalar<T>::type& c)
+{ return a /= c; }
+
+template<class T, Size N> inline
+Dual<T,N> operator/(const typename DualScalar<T>::type& c, const Dual<T,N>& a)
+{
+	const T y = c/a.value();
+	return a.chain(y, -y/a.value());
+}
+
+/*------------------------------------------------------------------------*/
+/*                                                   COMPARISON OPERATORS */
+
+#define NUMLIB_DUAL_COMPARISON( op )                                         \
+template<class T, Size N> inline                                             \
+bool operator op (const Dual<T,N>& a, const Dual<T,N>& b)                    \
+{ return a.value() op b.value(); }                                           \
+template<class T, Size N> inline                                             \
+bool operator op (const Dual<T,N>& a,                                        \
+                  const typename DualScalar<T>::type& c)                     \
+{ return a.value() op c; }                                                   \
+template<class T, Size N> inline                                             \
+bool operator op (const typename DualScalar<T>::type& c,                     \
+                  const Dual<T,N>& a)                                        \
+{ return c op a.value(); }
+
+NUMLIB_DUAL_COMPARISON( < )
+NUMLIB_DUAL_COMPARISON( > )
+NUMLIB_DUAL_COMPARISON( <= )
+NUMLIB_DUAL_COMPARISON( >= )
+NUMLIB_DUAL_COMPARISON( == )
+NUMLIB_DUAL_COMPARISON( != )
+
+#undef NUMLIB_DUAL_COMPARISON
+
+/*------------------------------------------------------------------------*/
+/*                                                         MATH FUNCTIONS */
+
+template<class T, Size N> inline
+Dual<T,N> sqrt(const Dual<T,N>& a)
+{
+	const T y = std::sqrt(a.value());
+	return a.chain(y, T(0.5)/y);
+}
+
+template<class T, Size N> inline
+Dual<T,N> exp(const Dual<T,N>& a)
+{
+	const T y = std::exp(a.value());
+	return a.chain(y, y);
+}
+
+template<class T, Size N> inline
+Dual<T,N> log(const Dual<T,N>& a)
+{
+	return a.chain(std::log(a.value()), T(1)/a.value());
+}
+
+template<class T, Size N> inline
+Dual<T,N> sin(const Dual<T,N>& a)
+{
+	return a.chain(std::sin(a.value()), std::cos(a.value()));
+}
+
+template<class T, Size N> inline
+Dual<T,N> cos(const Dual<T,N>& a)
+{
+	return a.chain(std::cos(a.value()), -std::sin(a.value()));
+}
+
+template<class T, Size N> inline
+Dual<T,N> tan(const Dual<T,N>& a)
+{
+	const T y = std::tan(a.value());
+	return a.chain(y, T(1) + y*y);
+}
+
+template<class T, Size N> inline
+Dual<T,N> atan(const Dual<T,N>& a)
+{
+	return a.chain(std::atan(a.value()), T(1)/(T(1) + a.value()*a.value()));
+}
+
+template<class T, Size N> inline
+Dual<T,N> tanh(const Dual<T,N>& a)
+{
+	const T y = std::tanh(a.value());
+	return a.chain(y, T(1) - y*y);
+}
+
+template<class T, Size N> inline
+Dual<T,N> pow(const Dual<T,N>& a, const typename DualScalar<T>::type& p)
+{
+	if(p == T(0)) return Dual<T,N>(T(1));
+	return a.chain(std::pow(a.value(), p), p*std::pow(a.value(), p - T(1)));
+}
+
+template<class T, Size N> inline
+Dual<T,N> pow(const Dual<T,N>& a, const Dual<T,N>& b)
+{
+	return exp(b*log(a));
+}
+
+template<class T, Size N> inline
+Dual<T,N> fabs(const Dual<T,N>& a)
+{
+	return a.value() < T(0) ? -a : a;
+}
+
+//! Computes the absolute value of a dual number
+template<class T, Size N> inline
+Dual<T,N> abs(const Dual<T,N>& a)
+{
+	return fabs(a);
+}
+
+//! Returns the sign of the value of a dual number
+template<class T, Size N> inline
+T sgn(const Dual<T,N>& a)
+{
+	return sgn(a.value());
+}
+
+//! Checks if the value of a dual number is zero
+template<class T, Size N> inline
+bool is_zero(const Dual<T,N>& a)
+{
+	return is_zero(a.value());
+}
+
+//! Writes the value followed by the derivatives
+template<class T, Size N>
+std::ostream& operator<<(std::ostream& os, const Dual<T,N>& a)
+{
+	os<<a.value();
+	for(Index k=0; k<N; ++k)
+		os<<" "<<a.derivative(k);
+	return os;
+}
+
+}//::numlib
+
+#endif
@@ -0,0 +1,102 @@
+/*! \file parallel_tools.h
+ *  \brief Thin wrappers around the OpenMP runtime
+ *
+ *  NumLib expresses shared memory parallelism with OpenMP pragmas. When
+ *  NumLib is compiled without OpenMP support the pragmas are ignored, and
+ *  the functions defined here fall back to their single threaded values;
+ *  thus, the same source compiles (and runs serially) either way.
+ */
+
+#ifndef PARALLEL_TOOLS_H
+#define PARALLEL_TOOLS_H
+
+#include "numlib-config.h"
+#include "nocopy.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace numlib{
+
+//! Returns the maximum number of threads a parallel region may use
+inline
+Size maxThreads()
+{
+#ifdef _OPENMP
+	return omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
+
+//! Returns the index of the calling thread within the current team
+/*!
+ *	The returned value is always less than maxThreads(), and may therefore
+ *	be used to select per-thread work space allocated prior to entering a
+ *	parallel region.
+ */
+inline
+Index threadIndex()
+{
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+//! Mutual exclusion lock
+/*!
+ *	Wraps an OpenMP lock; i.e. lock blocks until no other thread holds the
+ *	lock. Without OpenMP support, locking has no effect. Prefer ScopedLock
+ *	to calling lock and unlock directly.
+ */
+class Mutex
+{
+public:
+
+#ifdef _OPENMP
+	Mutex() {omp_init_lock(&omp_lock);}
+
+	~Mutex() {omp_destroy_lock(&omp_lock);}
+
+	void lock() {omp_set_lock(&omp_lock);}
+
+	void unlock() {omp_unset_lock(&omp_lock);}
+#else
+	Mutex() {}
+
+	void lock() {}
+
+	void unlock() {}
+#endif
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( Mutex );
+
+#ifdef _OPENMP
+	omp_lock_t omp_lock;
+#endif
+};
+
+//! Holds a Mutex for the lifetime of the object
+class ScopedLock
+{
+public:
+
+	explicit ScopedLock(Mutex& mutex_): mutex(mutex_) {mutex.lock();}
+
+	~ScopedLock() {mutex.unlock();}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( ScopedLock );
+
+	Mutex& mutex;
+};
+
+}//::numlib
+
+#endif
@@ -53,6 +53,71 @@ void randomVector(V& u, Real a, Real b)
 		u(i) = d*randomNumber() + s;
 }
 
+//! Seedable pseudo random number generator with independent state
+/*!
+ *	Unlike randomNumber, which draws from the global state of std::rand,
+ *	each instance holds its own state; thus, a sequence is determined by
+ *	its seed alone, and independent generators may be used concurrently
+ *	(e.g. one per thread). The generator is Marsaglia's 32 bit xorshift
+ *	(Marsaglia, G. "Xorshift RNGs." J. Stat. Softw. Vol. 8, No. 14, 2003),
+ *	with the seed scrambled so that nearby seeds (e.g. seed + i for the
+ *	i-th stream) give unrelated sequences. This is adequate for heuristic
+ *	optimizers, but not for statistical sampling.
+ */
+class RandomGenerator
+{
+public:
+
+	explicit RandomGenerator(unsigned long seed_=1) {seed(seed_);}
+
+	//! Restarts the sequence from the given seed
+	void seed(unsigned long s)
+	{
+		// Scramble seed (32 bit finalizer of MurmurHash3)...
+		s &= 0xffffffffUL;
+		s ^= s >> 16;
+		s = (s*0x85ebca6bUL) & 0xffffffffUL;
+		s ^= s >> 13;
+		s = (s*0xc2b2ae35UL) & 0xffffffffUL;
+		s ^= s >> 16;
+		state = (s == 0) ? 0x9e3779b9UL : s;
+	}
+
+	//! Generates a random integer between 1 and 2^32-1
+	unsigned long integer()
+	{
+		state ^= (state << 13) & 0xffffffffUL;
+		state ^= state >> 17;
+		state ^= (state << 5) & 0xffffffffUL;
+		return state;
+	}
+
+	//! Generates a floating point random number between 0.0 and 1.0
+	Real number()
+	{
+		return ((Real)integer())/4294967295.0;
+	}
+
+	//! Generates a floating point random number between a and b
+	Real number(Real a, Real b)
+	{
+		return a + (b - a)*number();
+	}
+
+	//! Populates a vector with random values between a and b
+	template<class V>
+	void vector(V& u, Real a, Real b)
+	{
+		for(Index i=0; i<u.size(); ++i)
+			u(i) = number(a, b);
+	}
+
+private:
+
+	unsigned long state;
+
+};
+
 }//::numlib
 
 #endif
@@ -51,6 +51,13 @@ public:
 	//! Returns the number of columns
 	const Size size2() const;
 
+	//! Resizes to (m+1) X m
+	/*!
+	 *  Element values of the leading columns are retained. Memory is only
+	 *  reallocated if m exceeds the number of columns previously allocated.
+	 */
+	void resize(Size m_);
+
 	//! Sets/returns (i,j) element
     /*!
      *  Access to the (i,j) element in the assumed zero region of the matrix
@@ -90,6 +97,9 @@ private:
 	// Number of columns
 	Size m;
 
+	// Number of allocated columns
+	Size cap;
+
 	// Matrix column vectors
 	Vector<T>* columns;
 
@@ -104,6 +114,7 @@ private:
 template<class T>
 ExtHessMatrix<T>::ExtHessMatrix(Size m_):
 	m(m_),
+	cap(m_),
 	columns(NULL),
 	zero(0)
 {
@@ -114,9 +125,10 @@ ExtHessMatrix<T>::ExtHessMatrix(Size m_):
 
 template<class T>
 ExtHessMatrix<T>::ExtHessMatrix(const ExtHessMatrix<T>& other):
-	m(0),columns(NULL),zero(0)
+	m(0),cap(0),columns(NULL),zero(0)
 {
 	m = other.m;
+	cap = m;
 	columns = new Vector<T>[m];
 	for(Index i=0; i<m; ++i)
 		columns[i] = other.columns[i];
@@ -125,10 +137,11 @@ ExtHessMatrix<T>::ExtHessMatrix(const ExtHessMatrix<T>& other):
 
 template<class T>
 ExtHessMatrix<T>::ExtHessMatrix(const HessMatrix<T>& hess):
-	m(0),columns(NULL),zero(0)
+	m(0),cap(0),columns(NULL),zero(0)
 {
 	// Get size...
 	m = hess.size2();
+	cap = m;
 
 	// Allocate ...
 	columns = new Vector<T>[m];
@@ -157,9 +170,7 @@ template<class T>
 ExtHessMatrix<T>& ExtHessMatrix<T>::operator=(const ExtHessMatrix<T>& other)
 {
     if(&other==this) return *this;
-    delete[] columns;
-    m = other.m;
-    columns = new Vector<T>[m];
+    resize(other.m);
     for(Index j=0; j<m; ++j)
         columns[j] = other.columns[j];
     return *this;
@@ -178,6 +189,23 @@ const Size ExtHessMatrix<T>::size2() const
 	return m;
 }
 
+template<class T>
+void ExtHessMatrix<T>::resize(Size m_)
+{
+	if(m_ > cap)
+	{
+		Vector<T>* tmp = new Vector<T>[m_];
+		for(Index j=0; j<cap; ++j)
+			tmp[j].swap(columns[j]);
+		for(Index j=cap; j<m_; ++j)
+			tmp[j].resize(j+2);
+		delete[] columns;
+		columns = tmp;
+		cap = m_;
+	}
+	m = m_;
+}
+
 template<class T>
 T& ExtHessMatrix<T>::operator()(Index i, Index j)
 {
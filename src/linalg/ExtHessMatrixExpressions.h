@@ -34,6 +34,24 @@ Vector<T> prod(const ExtHessMatrix<T> & a, const Vector<T> & u)
 	 return v;
 }
 
+//! Computes the left Extended Hessenberg matrix vector product in place
+/*!
+ *  On input, 'v' must have dimension m+1.
+ */
+template<class T>
+void prodIP(const ExtHessMatrix<T> & a, const Vector<T> & u, Vector<T> & v)
+{
+	 Size m = a.size2();
+
+	 ASSERT( u.size() == m );
+	 ASSERT( v.size() == m+1 );
+
+	 v.zero();
+	 for(Index j=0; j<m; ++j)
+		  for(Index i=0; i<j+2; ++i)
+			   v(i) += a(i,j)*u(j);
+}
+
 //! Directly solves min J(x), where J(x) = ||{b} - [H]{x}||_2
 /*!
  *  On input, 'hess' is the upper extented Hessinburg matrix [H] and 'x' is the RHS
@@ -64,7 +82,7 @@ void solveInPlaceLeastSquare(ExtHessMatrix<T>& hess, Vector<T>& x)
 		// Compute ith rotation ...
 		ta = hess(i,i);
 		tb = hess(i+1,i);
-		tc = sqrt( ta*ta + tb*tb );
+		tc = std::sqrt( ta*ta + tb*tb );
 		const Real s = tb/tc;
 		const Real c = ta/tc;
 
@@ -142,7 +142,7 @@ void factorLU(HessMatrix<T> & hess, Vector<Index> & p)
 
 		 // Pivot rows...
 
-		 if( fabs(hess(p(i-1),i-1)) < fabs(hess(p(i),i-1)) )
+		 if( std::fabs(hess(p(i-1),i-1)) < std::fabs(hess(p(i),i-1)) )
 		 {
 			 Index im1 = p(i-1);
 			 p(i-1) = p(i);
@@ -258,7 +258,7 @@ void solveInPlace(HessMatrix<T>& hess, Vector<T>& x)
 
 		// Pivot...
 
-		if( fabs(hess(p(i),i-1)) > fabs(hess(p(i-1),i-1)) )
+		if( std::fabs(hess(p(i),i-1)) > std::fabs(hess(p(i-1),i-1)) )
 		{
 			Index tmp = p(i-1);
 			p(i-1) = p(i);
@@ -0,0 +1,517 @@
+/*! \file LinearOperator.h
+ *  \brief Matrix-free linear operator algebra
+ *
+ *  A linear operator, A, is any type which implements the in-place product
+ *
+ *     prodIP(A, u, v)   // v = A*u
+ *
+ *  with v sized to the result upon input. The matrix types with in-place
+ *  products (SparseMatrix, StencilMatrix), and the Jacobian-vector product
+ *  operators of the solvers (GateauxFD, GateauxAD), implement prodIP
+ *  directly; any other type which implements only v = prod(A, u) is
+ *  supported through a fall-back, which copies the returned temporary.
+ *  Operators which also implement prodTransIP(A, u, v), v = A^T*u, may be
+ *  transposed.
+ *
+ *  The operator types defined here compose operators without forming
+ *  matrices: sums, products, scaling, shifting (e.g. the pseudo-transient
+ *  Jacobian I/dtau - J = shiftedOp(J, 1.0/dtau, -1.0)), transposes, and 2x2
+ *  block operators. Each composition evaluates into the caller's output
+ *  vector; scaling and shifting are fused into a single pass over the
+ *  output, and work vectors are held by (and allocated once per) composite
+ *  operator where a temporary is unavoidable (sums, products, and blocks).
+ *  Consequently, a composite operator may not be applied concurrently by
+ *  several threads.
+ *
+ *  Composite operators store their operands by reference, except for
+ *  composite operands, which are stored by value; thus, nested
+ *  compositions may be built from temporaries, e.g.
+ *
+ *     sumOp<Real>(scaledOp(2.0, A), productOp<Real>(B, C))
+ *
+ *  but matrix (and other non-composite) operands must outlive the
+ *  composition. Composite operators other than blocks assume square
+ *  operands.
+ */
+
+#ifndef LINEAROPERATOR_H
+#define LINEAROPERATOR_H
+
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "Vector.h"
+#include "VectorExpressions.h"
+
+namespace numlib{ namespace linalg{
+
+//! Evaluates v = A*u for operators which only implement v = prod(A, u)
+template<class L, class T>
+void prodIP(const L & a, const Vector<T> & u, Vector<T> & v)
+{
+  v = prod(a, u);
+}
+
+//! Storage of an operand within a composite operator (by reference)
+template<class L>
+struct OperatorStorage
+{
+  typedef const L & type;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                                                SUM: A + B */
+
+//! Model of the operator sum A + B
+template<class T, class A, class B>
+class SumOperator
+{
+public:
+
+  SumOperator(const A & a_, const B & b_): a(a_), b(b_), w(0) {}
+
+  void eval(const Vector<T> & u, Vector<T> & v) const
+  {
+	if(w.size() != u.size()) w.resize(u.size());
+	prodIP(a, u, v);
+	prodIP(b, u, w);
+	v += w;
+  }
+
+  void evalTrans(const Vector<T> & u, Vector<T> & v) const
+  {
+	if(w.size() != u.size()) w.resize(u.size());
+	prodTransIP(a, u, v);
+	prodTransIP(b, u, w);
+	v += w;
+  }
+
+private:
+
+  typename OperatorStorage<A>::type a;
+
+  typename OperatorStorage<B>::type b;
+
+  //! Work vector holding B*u
+  mutable Vector<T> w;
+};
+
+template<class T, class A, class B>
+struct OperatorStorage< SumOperator<T,A,B> >
+{
+  typedef SumOperator<T,A,B> type;
+};
+
+//! Returns the operator sum A + B
+template<class T, class A, class B> inline
+SumOperator<T,A,B> sumOp(const A & a, const B & b)
+{
+  return SumOperator<T,A,B>(a, b);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                                            PRODUCT: A*B */
+
+//! Model of the operator product A*B
+template<class T, class A, class B>
+class ProductOperator
+{
+public:
+
+  ProductOperator(const A & a_, const B & b_): a(a_), b(b_), w(0) {}
+
+  void eval(const Vector<T> & u, Vector<T> & v) const
+  {
+	if(w.size() != u.size()) w.resize(u.size());
+	prodIP(b, u, w);
+	prodIP(a, w, v);
+  }
+
+  void evalTrans(const Vector<T> & u, Vector<T> & v) const
+  {
+	if(w.size() != u.size()) w.resize(u.size());
+	prodTransIP(a, u, w);
+	prodTransIP(b, w, v);
+  }
+
+private:
+
+  typename OperatorStorage<A>::type a;
+
+  typename OperatorStorage<B>::type b;
+
+  //! Work vector holding B*u
+  mutable Vector<T> w;
+};
+
+template<class T, class A, class B>
+struct OperatorStorage< ProductOperator<T,A,B> >
+{
+  typedef ProductOperator<T,A,B> type;
+};
+
+//! Returns the operator product A*B
+template<class T, class A, class B> inline
+ProductOperator<T,A,B> productOp(const A & a, const B & b)
+{
+  return ProductOperator<T,A,B>(a, b);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                                                 SCALED: c*A */
+
+//! Model of the scaled operator c*A
+template<class T, class A>
+class ScaledOperator
+{
+public:
+
+  ScaledOperator(const T & c_, const A & a_): c(c_), a(a_) {}
+
+  void eval(const Vector<T> & u, Vector<T> & v) const
+  {
+	prodIP(a, u, v);
+	v *= c;
+  }
+
+  void evalTrans(const Vector<T> & u, Vector<T> & v) const
+  {
+	prodTransIP(a, u, v);
+	v *= c;
+  }
+
+private:
+
+  T c;
+
+  typename OperatorStorage<A>::type a;
+};
+
+template<class T, class A>
+struct OperatorStorage< ScaledOperator<T,A> >
+{
+  typedef ScaledOperator<T,A> type;
+};
+
+//! Returns the scaled operator c*A
+template<class T, class A> inline
+ScaledOperator<T,A> scaledOp(const T & c, const A & a)
+{
+  return ScaledOperator<T,A>(c, a);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                                     SHIFTED: c*A + sigma*I */
+
+//! Model of the shifted operator c*A + sigma*I
+template<class T, class A>
+class ShiftedOperator
+{
+public:
+
+  ShiftedOperator(const A & a_, const T & sigma_, const T & c_):
+	a(a_), sigma(sigma_), c(c_) {}
+
+  void eval(const Vector<T> & u, Vector<T> & v) const
+  {
+	prodIP(a, u, v);
+	shift(u, v);
+  }
+
+  void evalTrans(const Vector<T> & u, Vector<T> & v) const
+  {
+	prodTransIP(a, u, v);
+	shift(u, v);
+  }
+
+private:
+
+  typename OperatorStorage<A>::type a;
+
+  T sigma;
+
+  T c;
+
+  // Fused update v = c*v + sigma*u
+  void shift(const Vector<T> & u, Vector<T> & v) const
+  {
+	ASSERT( u.size() == v.size() );
+	for(Index i=0; i<v.size(); ++i)
+	  v(i) = c*v(i) + sigma*u(i);
+  }
+};
+
+template<class T, class A>
+struct OperatorStorage< ShiftedOperator<T,A> >
+{
+  typedef ShiftedOperator<T,A> type;
+};
+
+//! Returns the shifted operator c*A + sigma*I
+template<class T, class A> inline
+ShiftedOperator<T,A> shiftedOp(const A & a, const T & sigma, const T & c=T(1))
+{
+  return ShiftedOperator<T,A>(a, sigma, c);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                                             TRANSPOSE: A^T */
+
+//! Model of the transposed operator A^T
+template<class A>
+class TransposeOperator
+{
+public:
+
+  explicit TransposeOperator(const A & a_): a(a_) {}
+
+  template<class T>
+  void eval(const Vector<T> & u, Vector<T> & v) const
+  {
+	prodTransIP(a, u, v);
+  }
+
+  template<class T>
+  void evalTrans(const Vector<T> & u, Vector<T> & v) const
+  {
+	prodIP(a, u, v);
+  }
+
+private:
+
+  typename OperatorStorage<A>::type a;
+};
+
+template<class A>
+struct OperatorStorage< TransposeOperator<A> >
+{
+  typedef TransposeOperator<A> type;
+};
+
+//! Returns the transposed operator A^T
+template<class A> inline
+TransposeOperator<A> transposeOp(const A & a)
+{
+  return TransposeOperator<A>(a);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                                     BLOCK: [A11 A12; A21 A22] */
+
+//! Model of the 2x2 block operator [A11 A12; A21 A22]
+/*!
+ *  The first n1 elements of u (and v) belong to the first block row
+ *  (column), and the remaining n2 elements to the second; i.e. A11 is n1 x n1,
+ *  A12 is n1 x n2, A21 is n2 x n1, and A22 is n2 x n2. The partitions are
+ *  copied to (and from) work vectors (see getPartition).
+ */
+template<class T, class A11, class A12, class A21, class A22>
+class BlockOperator
+{
+public:
+
+  BlockOperator(const A11 & a11_, const A12 & a12_, const A21 & a21_,
+	const A22 & a22_, Size n1_, Size n2_):
+	a11(a11_), a12(a12_), a21(a21_), a22(a22_), n1(n1_), n2(n2_),
+	u1(n1_), u2(n2_), v1(n1_), v2(n2_), w1(n1_), w2(n2_) {}
+
+  void eval(const Vector<T> & u, Vector<T> & v) const
+  {
+	ASSERT( u.size() == n1 + n2 );
+	ASSERT( v.size() == n1 + n2 );
+
+	getPartition(u, u1, 0, n1);
+	getPartition(u, u2, n1, n1+n2);
+
+	prodIP(a11, u1, v1);
+	prodIP(a12, u2, w1);
+	v1 += w1;
+
+	prodIP(a21, u1, v2);
+	prodIP(a22, u2, w2);
+	v2 += w2;
+
+	setPartition(v, v1, 0, n1);
+	setPartition(v, v2, n1, n1+n2);
+  }
+
+  void evalTrans(const Vector<T> & u, Vector<T> & v) const
+  {
+	ASSERT( u.size() == n1 + n2 );
+	ASSERT( v.size() == n1 + n2 );
+
+	getPartition(u, u1, 0, n1);
+	getPartition(u, u2, n1, n1+n2);
+
+	prodTransIP(a11, u1, v1);
+	prodTransIP(a21, u2, w1);
+	v1 += w1;
+
+	prodTransIP(a12, u1, v2);
+	prodTransIP(a22, u2, w2);
+	v2 += w2;
+
+	setPartition(v, v1, 0, n1);
+	setPartition(v, v2, n1, n1+n2);
+  }
+
+private:
+
+  typename OperatorStorage<A11>::type a11;
+  typename OperatorStorage<A12>::type a12;
+  typename OperatorStorage<A21>::type a21;
+  typename OperatorStorage<A22>::type a22;
+
+  //! Block sizes
+  Size n1, n2;
+
+  //! Work vectors (partitions of u and v, and partial products)
+  mutable Vector<T> u1, u2, v1, v2, w1, w2;
+};
+
+template<class T, class A11, class A12, class A21, class A22>
+struct OperatorStorage< BlockOperator<T,A11,A12,A21,A22> >
+{
+  typedef BlockOperator<T,A11,A12,A21,A22> type;
+};
+
+//! Returns the 2x2 block operator [A11 A12; A21 A22]
+template<class T, class A11, class A12, class A21, class A22> inline
+BlockOperator<T,A11,A12,A21,A22> blockOp(const A11 & a11, const A12 & a12,
+  const A21 & a21, const A22 & a22, Size n1, Size n2)
+{
+  return BlockOperator<T,A11,A12,A21,A22>(a11, a12, a21, a22, n1, n2);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                                        PRODUCT FUNCTIONS */
+
+//! Evaluates v = A*u for composite operators
+template<class T, class A, class B>
+void prodIP(const SumOperator<T,A,B> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.eval(u, v);
+}
+
+template<class T, class A, class B>
+void prodIP(const ProductOperator<T,A,B> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.eval(u, v);
+}
+
+template<class T, class A>
+void prodIP(const ScaledOperator<T,A> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.eval(u, v);
+}
+
+template<class T, class A>
+void prodIP(const ShiftedOperator<T,A> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.eval(u, v);
+}
+
+template<class T, class A>
+void prodIP(const TransposeOperator<A> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.eval(u, v);
+}
+
+template<class T, class A11, class A12, class A21, class A22>
+void prodIP(const BlockOperator<T,A11,A12,A21,A22> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.eval(u, v);
+}
+
+//! Evaluates v = A^T*u for composite operators
+template<class T, class A, class B>
+void prodTransIP(const SumOperator<T,A,B> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.evalTrans(u, v);
+}
+
+template<class T, class A, class B>
+void prodTransIP(const ProductOperator<T,A,B> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.evalTrans(u, v);
+}
+
+template<class T, class A>
+void prodTransIP(const ScaledOperator<T,A> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.evalTrans(u, v);
+}
+
+template<class T, class A>
+void prodTransIP(const ShiftedOperator<T,A> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.evalTrans(u, v);
+}
+
+template<class T, class A>
+void prodTransIP(const TransposeOperator<A> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.evalTrans(u, v);
+}
+
+template<class T, class A11, class A12, class A21, class A22>
+void prodTransIP(const BlockOperator<T,A11,A12,A21,A22> & a, const Vector<T> & u, Vector<T> & v)
+{
+  a.evalTrans(u, v);
+}
+
+//! Evaluates the left product of a composite operator (returns a new vector)
+/*!
+ *  Provided for compatibility with code written against v = prod(A, u); the
+ *  result has the size of u (square operators).
+ */
+template<class T, class A, class B>
+Vector<T> prod(const SumOperator<T,A,B> & a, const Vector<T> & u)
+{
+  Vector<T> v(u.size());
+  a.eval(u, v);
+  return v;
+}
+
+template<class T, class A, class B>
+Vector<T> prod(const ProductOperator<T,A,B> & a, const Vector<T> & u)
+{
+  Vector<T> v(u.size());
+  a.eval(u, v);
+  return v;
+}
+
+template<class T, class A>
+Vector<T> prod(const ScaledOperator<T,A> & a, const Vector<T> & u)
+{
+  Vector<T> v(u.size());
+  a.eval(u, v);
+  return v;
+}
+
+template<class T, class A>
+Vector<T> prod(const ShiftedOperator<T,A> & a, const Vector<T> & u)
+{
+  Vector<T> v(u.size());
+  a.eval(u, v);
+  return v;
+}
+
+template<class T, class A>
+Vector<T> prod(const TransposeOperator<A> & a, const Vector<T> & u)
+{
+  Vector<T> v(u.size());
+  a.eval(u, v);
+  return v;
+}
+
+template<class T, class A11, class A12, class A21, class A22>
+Vector<T> prod(const BlockOperator<T,A11,A12,A21,A22> & a, const Vector<T> & u)
+{
+  Vector<T> v(u.size());
+  a.eval(u, v);
+  return v;
+}
+
+}}//::numlib::linalg
+
+#endif
@@ -0,0 +1,206 @@
+/*! \file SparseMatrix-inl.h
+ */
+
+namespace numlib{ namespace linalg{
+
+template<class T>
+SparseMatrix<T>::SparseMatrix():
+	n(0),
+	m(0),
+	zero_elem(0),
+	rowPtr(1),
+	colIdx(0),
+	val(0)
+{
+	rowPtr(0) = 0;
+}
+
+template<class T>
+SparseMatrix<T>::SparseMatrix(Size nrows, Size ncols,
+	const IndexArray& row_ptr, const IndexArray& col_idx):
+	n(0),
+	m(0),
+	zero_elem(0)
+{
+	setPattern(nrows, ncols, row_ptr, col_idx);
+}
+
+template<class T>
+SparseMatrix<T>::SparseMatrix(const SparseMatrix& other):
+	n(other.n),
+	m(other.m),
+	zero_elem(0),
+	rowPtr(other.rowPtr),
+	colIdx(other.colIdx),
+	val(other.val)
+{
+}
+
+template<class T>
+SparseMatrix<T>::~SparseMatrix()
+{
+	/* nothing to delete */
+}
+
+template<class T>
+SparseMatrix<T>& SparseMatrix<T>::operator=(const SparseMatrix& other)
+{
+	if(&other==this) return *this;
+
+	n = other.n;
+	m = other.m;
+	rowPtr = other.rowPtr;
+	colIdx = other.colIdx;
+	val = other.val;
+
+	return *this;
+}
+
+template<class T> inline
+Size SparseMatrix<T>::size1() const {return n;}
+
+template<class T> inline
+Size SparseMatrix<T>::size2() const {return m;}
+
+template<class T> inline
+Size SparseMatrix<T>::nnz() const {return colIdx.size();}
+
+template<class T>
+void SparseMatrix<T>::setPattern(Size nrows, Size ncols,
+	const IndexArray& row_ptr, const IndexArray& col_idx)
+{
+	ASSERT( row_ptr.size() == nrows + 1 );
+	ASSERT( row_ptr(0) == 0 );
+	ASSERT( col_idx.size() == row_ptr(nrows) );
+
+	n = nrows;
+	m = ncols;
+	rowPtr = row_ptr;
+	colIdx = col_idx;
+
+#ifdef DEBUG
+	for(Index i=0; i<n; ++i)
+	{
+		ASSERT( rowPtr(i) <= rowPtr(i+1) );
+		for(Index k=rowPtr(i); k<rowPtr(i+1); ++k)
+		{
+			ASSERT( colIdx(k) < m );
+			ASSERT( k == rowPtr(i) or colIdx(k-1) < colIdx(k) );
+		}
+	}
+#endif
+
+	val.resize(colIdx.size());
+	zero();
+}
+
+template<class T> inline
+Index SparseMatrix<T>::rowBegin(Index i) const
+{
+	ASSERT( i < n );
+	return rowPtr(i);
+}
+
+template<class T> inline
+Index SparseMatrix<T>::rowEnd(Index i) const
+{
+	ASSERT( i < n );
+	return rowPtr(i+1);
+}
+
+template<class T> inline
+Index SparseMatrix<T>::column(Index k) const
+{
+	return colIdx(k);
+}
+
+template<class T>
+Index SparseMatrix<T>::find(Index i, Index j) const
+{
+	ASSERT( i < n );
+	ASSERT( j < m );
+
+	// Binary search of the (sorted) column indices of row i...
+
+	Index lo = rowPtr(i);
+	Index hi = rowPtr(i+1);
+	while(lo < hi)
+	{
+		Index mid = lo + (hi - lo)/2;
+		if(colIdx(mid) < j)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if(lo < rowPtr(i+1) and colIdx(lo) == j)
+		return lo;
+
+	return nnz();
+}
+
+template<class T> inline
+T& SparseMatrix<T>::value(Index k)
+{
+	return val(k);
+}
+
+template<class T> inline
+const T& SparseMatrix<T>::value(Index k) const
+{
+	return val(k);
+}
+
+template<class T>
+const T& SparseMatrix<T>::operator()(Index i, Index j) const
+{
+	Index k = find(i,j);
+	if(k < nnz())
+		return val(k);
+	return zero_elem;
+}
+
+template<class T>
+void SparseMatrix<T>::zero()
+{
+	for(Index k=0; k<val.size(); ++k)
+		val(k) = zero_elem;
+}
+
+template<class T>
+SparseMatrix<T>& SparseMatrix<T>::operator*=(const T& c)
+{
+	for(Index k=0; k<val.size(); ++k)
+		val(k) *= c;
+	return *this;
+}
+
+template<class T>
+SparseMatrix<T>& SparseMatrix<T>::operator/=(const T& c)
+{
+	for(Index k=0; k<val.size(); ++k)
+		val(k) /= c;
+	return *this;
+}
+
+template<class T>
+SparseMatrix<T>& SparseMatrix<T>::operator+=(const SparseMatrix& other)
+{
+	ASSERT( other.n == n );
+	ASSERT( other.nnz() == nnz() );
+	for(Index k=0; k<val.size(); ++k)
+		val(k) += other.val(k);
+	return *this;
+}
+
+template<class T>
+SparseMatrix<T>& SparseMatrix<T>::operator-=(const SparseMatrix& other)
+{
+	ASSERT( other.n == n );
+	ASSERT( other.nnz() == nnz() );
+	for(Index k=0; k<val.size(); ++k)
+		val(k) -= other.val(k);
+	return *this;
+}
+
+}}//::numlib::linalg
@@ -0,0 +1,132 @@
+/*! \file SparseMatrix.h
+ *  \brief Compressed sparse row matrix class definition
+ */
+
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../array/Array1D.h"
+
+namespace numlib{ namespace linalg{
+
+//! Model of a sparse matrix in compressed sparse row (CSR) format
+/*!
+ *  The non-zero elements of row i are stored contiguously, at positions
+ *  k = rowBegin(i),...,rowEnd(i)-1, with column indices column(k) and
+ *  values value(k). Column indices are stored in ascending order within
+ *  each row.
+ *
+ *  The sparsity pattern is fixed once defined (see setPattern); only the
+ *  values of the (structurally) non-zero elements may be modified. This
+ *  allows a matrix to be reassembled repeatedly (e.g. a Jacobian at each
+ *  Newton iteration) without reallocation.
+ */
+template<class T>
+class SparseMatrix
+{
+public:
+
+	typedef array::Array1D<Index> IndexArray;
+
+	SparseMatrix();
+
+	//! Creates an nrows by ncols matrix with the given sparsity pattern
+	/*!
+	 *  row_ptr := Start of each row in col_idx (size nrows+1)
+	 *  col_idx := Column index of each non-zero (size row_ptr(nrows))
+	 *
+	 *  Values are initialized to zero.
+	 */
+	SparseMatrix(Size nrows, Size ncols, const IndexArray& row_ptr,
+		const IndexArray& col_idx);
+
+	SparseMatrix(const SparseMatrix& other);
+
+	~SparseMatrix();
+
+	SparseMatrix& operator=(const SparseMatrix& other);
+
+	/*------------------------------------------------------------------------*/
+	/*                                                    MATRIX SIZE/PATTERN */
+
+	//! Returns the first matrix dimension (number of rows)
+	Size size1() const;
+
+	//! Returns the second matrix dimension (number of columns)
+	Size size2() const;
+
+	//! Returns the number of (structurally) non-zero elements
+	Size nnz() const;
+
+	//! Redefines the sparsity pattern; values are set to zero
+	void setPattern(Size nrows, Size ncols, const IndexArray& row_ptr,
+		const IndexArray& col_idx);
+
+	//! Returns position of the first non-zero in row i
+	Index rowBegin(Index i) const;
+
+	//! Returns position of the last non-zero in row i plus 1
+	Index rowEnd(Index i) const;
+
+	//! Returns column index of the non-zero at position k
+	Index column(Index k) const;
+
+	//! Returns position of element i,j, or nnz() if not in the pattern
+	Index find(Index i, Index j) const;
+
+	/*------------------------------------------------------------------------*/
+	/*                                                         ELEMENT ACCESS */
+
+	//! Returns mutable reference to the non-zero at position k
+	T& value(Index k);
+
+	//! Returns immutable reference to the non-zero at position k
+	const T& value(Index k) const;
+
+	//! Returns matrix element i,j (zero if not in the pattern)
+	const T& operator()(Index i, Index j) const;
+
+	//! Sets all non-zero values to zero (pattern is preserved)
+	void zero();
+
+	/*------------------------------------------------------------------------*/
+	/*                                                     IN-PLACE OPERATORS */
+
+	SparseMatrix& operator*=(const T& c);
+
+	SparseMatrix& operator/=(const T& c);
+
+	//! Adds a matrix with the same sparsity pattern
+	SparseMatrix& operator+=(const SparseMatrix& other);
+
+	//! Subtracts a matrix with the same sparsity pattern
+	SparseMatrix& operator-=(const SparseMatrix& other);
+
+private:
+
+	//! Number of rows
+	Size n;
+
+	//! Number of columns
+	Size m;
+
+	//! Zero element
+	T zero_elem;
+
+	//! Start of each row (size n+1)
+	IndexArray rowPtr;
+
+	//! Column index of each non-zero
+	IndexArray colIdx;
+
+	//! Value of each non-zero
+	array::Array1D<T> val;
+};
+
+}}//::numlib::linalg
+
+#include "SparseMatrix-inl.h"
+
+#endif
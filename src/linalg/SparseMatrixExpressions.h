@@ -0,0 +1,75 @@
+/*! \file SparseMatrixExpressions.h
+ */
+
+#ifndef SPARSEMATRIXEXPRESSIONS_H
+#define SPARSEMATRIXEXPRESSIONS_H
+
+#include "Vector.h"
+#include "SparseMatrix.h"
+
+namespace numlib{ namespace linalg{
+
+//! Evaluates the sparse matrix vector product v = A*u
+template<class T>
+void prod(const SparseMatrix<T> & a, const Vector<T> & u, Vector<T> & v)
+{
+  ASSERT( u.size() == a.size2() );
+  ASSERT( v.size() == a.size1() );
+  ASSERT( &u != &v );
+
+  for(Index i=0; i<a.size1(); ++i)
+  {
+	T vi(0);
+	for(Index k=a.rowBegin(i); k<a.rowEnd(i); ++k)
+	  vi += a.value(k)*u(a.column(k));
+	v(i) = vi;
+  }
+}
+
+//! Evaluates the left sparse matrix vector product
+template<class T>
+Vector<T> prod(const SparseMatrix<T> & a, const Vector<T> & u)
+{
+  Vector<T> v(a.size1());
+  prod(a, u, v);
+  return v;
+}
+
+//! Evaluates the sparse matrix vector product v = A*u (linear operator interface)
+template<class T> inline
+void prodIP(const SparseMatrix<T> & a, const Vector<T> & u, Vector<T> & v)
+{
+  prod(a, u, v);
+}
+
+//! Evaluates the transposed sparse matrix vector product v = A^T*u
+template<class T>
+void prodTransIP(const SparseMatrix<T> & a, const Vector<T> & u, Vector<T> & v)
+{
+  ASSERT( u.size() == a.size1() );
+  ASSERT( v.size() == a.size2() );
+  ASSERT( &u != &v );
+
+  v.zero();
+  for(Index i=0; i<a.size1(); ++i)
+  {
+	const T ui = u(i);
+	for(Index k=a.rowBegin(i); k<a.rowEnd(i); ++k)
+	  v(a.column(k)) += a.value(k)*ui;
+  }
+}
+
+//! Returns the diagonal of A (zero where not stored)
+template<class T>
+Vector<T> diagonal(const SparseMatrix<T> & a)
+{
+  Size n = min(a.size1(), a.size2());
+  Vector<T> d(n);
+  for(Index i=0; i<n; ++i)
+	d(i) = a(i,i);
+  return d;
+}
+
+}}//::numlib::linalg
+
+#endif
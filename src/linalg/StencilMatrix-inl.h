@@ -0,0 +1,152 @@
+/*! \file StencilMatrix-inl.h
+ */
+
+namespace numlib{ namespace linalg{
+
+template<class T>
+StencilMatrix<T>::StencilMatrix(Size n0, Size n1, Size n2):
+	d(0),
+	nc(0),
+	coef(0)
+{
+	resize(n0, n1, n2);
+}
+
+template<class T>
+StencilMatrix<T>::StencilMatrix(const StencilMatrix& other):
+	d(other.d),
+	nc(other.nc),
+	coef(other.coef)
+{
+	for(Index a=0; a<3; ++a)
+		n[a] = other.n[a];
+}
+
+template<class T>
+StencilMatrix<T>::~StencilMatrix()
+{
+	/* nothing to delete */
+}
+
+template<class T>
+StencilMatrix<T>& StencilMatrix<T>::operator=(const StencilMatrix& other)
+{
+	if(&other==this) return *this;
+
+	for(Index a=0; a<3; ++a)
+		n[a] = other.n[a];
+	d = other.d;
+	nc = other.nc;
+	coef = other.coef;
+
+	return *this;
+}
+
+template<class T>
+void StencilMatrix<T>::resize(Size n0, Size n1, Size n2)
+{
+	n[0] = n0;
+	n[1] = n1;
+	n[2] = n2;
+
+	if(n2 > 1)
+		d = 3;
+	else if(n1 > 1)
+		d = 2;
+	else
+		d = 1;
+
+	nc = 2*d + 1;
+	coef.resize(nc*n0*n1*n2);
+	zero();
+}
+
+template<class T> inline
+Size StencilMatrix<T>::dim() const {return d;}
+
+template<class T> inline
+Size StencilMatrix<T>::gridSize(Index a) const
+{
+	ASSERT( a < 3 );
+	return n[a];
+}
+
+template<class T> inline
+Size StencilMatrix<T>::stride(Index a) const
+{
+	ASSERT( a < 3 );
+	if(a == 0) return 1;
+	if(a == 1) return n[0];
+	return n[0]*n[1];
+}
+
+template<class T> inline
+Size StencilMatrix<T>::size1() const {return n[0]*n[1]*n[2];}
+
+template<class T> inline
+Size StencilMatrix<T>::size2() const {return size1();}
+
+template<class T> inline
+T& StencilMatrix<T>::center(Index p)
+{
+	return coef(nc*p);
+}
+
+template<class T> inline
+T& StencilMatrix<T>::lower(Index p, Index a)
+{
+	ASSERT( a < d );
+	return coef(nc*p + 2*a + 1);
+}
+
+template<class T> inline
+T& StencilMatrix<T>::upper(Index p, Index a)
+{
+	ASSERT( a < d );
+	return coef(nc*p + 2*a + 2);
+}
+
+template<class T> inline
+const T& StencilMatrix<T>::center(Index p) const
+{
+	return coef(nc*p);
+}
+
+template<class T> inline
+const T& StencilMatrix<T>::lower(Index p, Index a) const
+{
+	ASSERT( a < d );
+	return coef(nc*p + 2*a + 1);
+}
+
+template<class T> inline
+const T& StencilMatrix<T>::upper(Index p, Index a) const
+{
+	ASSERT( a < d );
+	return coef(nc*p + 2*a + 2);
+}
+
+template<class T>
+void StencilMatrix<T>::zero()
+{
+	for(Index k=0; k<coef.size(); ++k)
+		coef(k) = T(0);
+}
+
+template<class T>
+StencilMatrix<T>& StencilMatrix<T>::operator*=(const T& c)
+{
+	for(Index k=0; k<coef.size(); ++k)
+		coef(k) *= c;
+	return *this;
+}
+
+template<class T>
+StencilMatrix<T>& StencilMatrix<T>::operator/=(const T& c)
+{
+	for(Index k=0; k<coef.size(); ++k)
+		coef(k) /= c;
+	return *this;
+}
+
+}}//::numlib::linalg
@@ -0,0 +1,108 @@
+/*! \file StencilMatrix.h
+ *  \brief Structured grid stencil matrix class definition
+ */
+
+#ifndef STENCILMATRIX_H
+#define STENCILMATRIX_H
+
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../array/Array1D.h"
+
+namespace numlib{ namespace linalg{
+
+//! Model of a compact (2d+1 point) stencil operator on a structured grid
+/*!
+ *  The unknowns are associated with the nodes of an n0 x n1 x n2 structured
+ *  grid, and are ordered with the first index varying fastest; i.e. node
+ *  (i,j,k) has index p = i + n0*(j + n1*k). The grid dimension, d, is the
+ *  number of leading axes in use (d = 1 if n1 = n2 = 1, d = 2 if n2 = 1,
+ *  otherwise d = 3).
+ *
+ *  Each row, p, couples node p with its two neighbors along each axis,
+ *  with (variable) coefficients center(p), lower(p,a), and upper(p,a); i.e.
+ *  3, 5, and 7 point stencils in 1, 2, and 3 dimensions respectively.
+ *  Coefficients which couple to nodes outside the grid are ignored.
+ */
+template<class T>
+class StencilMatrix
+{
+public:
+
+	StencilMatrix(Size n0=0, Size n1=1, Size n2=1);
+
+	StencilMatrix(const StencilMatrix& other);
+
+	~StencilMatrix();
+
+	StencilMatrix& operator=(const StencilMatrix& other);
+
+	/*------------------------------------------------------------------------*/
+	/*                                                      GRID/MATRIX SIZE */
+
+	//! Resizes grid to n0 x n1 x n2; coefficients are set to zero
+	void resize(Size n0, Size n1=1, Size n2=1);
+
+	//! Returns the grid dimension, d
+	Size dim() const;
+
+	//! Returns the number of grid nodes along axis a
+	Size gridSize(Index a) const;
+
+	//! Returns the index offset between neighbors along axis a
+	Size stride(Index a) const;
+
+	//! Returns the first matrix dimension (number of nodes)
+	Size size1() const;
+
+	//! Returns the second matrix dimension (number of nodes)
+	Size size2() const;
+
+	/*------------------------------------------------------------------------*/
+	/*                                                    COEFFICIENT ACCESS */
+
+	//! Sets/returns the diagonal coefficient of row p
+	T& center(Index p);
+
+	//! Sets/returns the coefficient coupling node p to its lower neighbor along axis a
+	T& lower(Index p, Index a);
+
+	//! Sets/returns the coefficient coupling node p to its upper neighbor along axis a
+	T& upper(Index p, Index a);
+
+	const T& center(Index p) const;
+
+	const T& lower(Index p, Index a) const;
+
+	const T& upper(Index p, Index a) const;
+
+	//! Sets all coefficients to zero
+	void zero();
+
+	/*------------------------------------------------------------------------*/
+	/*                                                     IN-PLACE OPERATORS */
+
+	StencilMatrix& operator*=(const T& c);
+
+	StencilMatrix& operator/=(const T& c);
+
+private:
+
+	//! Grid size along each axis
+	Size n[3];
+
+	//! Grid dimension
+	Size d;
+
+	//! Number of coefficients per row (2d+1)
+	Size nc;
+
+	//! Coefficients (row major; center, lower/upper for axis 0, ...)
+	array::Array1D<T> coef;
+};
+
+}}//::numlib::linalg
+
+#include "StencilMatrix-inl.h"
+
+#endif
@@ -0,0 +1,120 @@
+/*! \file StencilMatrixExpressions.h
+ */
+
+#ifndef STENCILMATRIXEXPRESSIONS_H
+#define STENCILMATRIXEXPRESSIONS_H
+
+#include "Vector.h"
+#include "StencilMatrix.h"
+
+namespace numlib{ namespace linalg{
+
+//! Evaluates the stencil matrix vector product v = A*u
+template<class T>
+void prod(const StencilMatrix<T> & a, const Vector<T> & u, Vector<T> & v)
+{
+  ASSERT( u.size() == a.size2() );
+  ASSERT( v.size() == a.size1() );
+  ASSERT( &u != &v );
+
+  const Size n0 = a.gridSize(0);
+  const Size n1 = a.gridSize(1);
+  const Size n2 = a.gridSize(2);
+  const Size d = a.dim();
+
+  #pragma omp parallel for
+  for(Index k=0; k<n2; ++k)
+  {
+	for(Index j=0; j<n1; ++j)
+	{
+	  for(Index i=0; i<n0; ++i)
+	  {
+		const Index p = i + n0*(j + n1*k);
+		T vp = a.center(p)*u(p);
+		if(i > 0)    vp += a.lower(p,0)*u(p-1);
+		if(i+1 < n0) vp += a.upper(p,0)*u(p+1);
+		if(d > 1)
+		{
+		  if(j > 0)    vp += a.lower(p,1)*u(p-n0);
+		  if(j+1 < n1) vp += a.upper(p,1)*u(p+n0);
+		}
+		if(d > 2)
+		{
+		  if(k > 0)    vp += a.lower(p,2)*u(p-n0*n1);
+		  if(k+1 < n2) vp += a.upper(p,2)*u(p+n0*n1);
+		}
+		v(p) = vp;
+	  }
+	}
+  }
+}
+
+//! Evaluates the left stencil matrix vector product
+template<class T>
+Vector<T> prod(const StencilMatrix<T> & a, const Vector<T> & u)
+{
+  Vector<T> v(a.size1());
+  prod(a, u, v);
+  return v;
+}
+
+//! Evaluates the stencil matrix vector product v = A*u (linear operator interface)
+template<class T> inline
+void prodIP(const StencilMatrix<T> & a, const Vector<T> & u, Vector<T> & v)
+{
+  prod(a, u, v);
+}
+
+//! Evaluates the transposed stencil matrix vector product v = A^T*u
+template<class T>
+void prodTransIP(const StencilMatrix<T> & a, const Vector<T> & u, Vector<T> & v)
+{
+  ASSERT( u.size() == a.size1() );
+  ASSERT( v.size() == a.size2() );
+  ASSERT( &u != &v );
+
+  const Size n0 = a.gridSize(0);
+  const Size n1 = a.gridSize(1);
+  const Size n2 = a.gridSize(2);
+  const Size d = a.dim();
+
+  #pragma omp parallel for
+  for(Index k=0; k<n2; ++k)
+  {
+	for(Index j=0; j<n1; ++j)
+	{
+	  for(Index i=0; i<n0; ++i)
+	  {
+		const Index p = i + n0*(j + n1*k);
+		T vp = a.center(p)*u(p);
+		if(i > 0)    vp += a.upper(p-1,0)*u(p-1);
+		if(i+1 < n0) vp += a.lower(p+1,0)*u(p+1);
+		if(d > 1)
+		{
+		  if(j > 0)    vp += a.upper(p-n0,1)*u(p-n0);
+		  if(j+1 < n1) vp += a.lower(p+n0,1)*u(p+n0);
+		}
+		if(d > 2)
+		{
+		  if(k > 0)    vp += a.upper(p-n0*n1,2)*u(p-n0*n1);
+		  if(k+1 < n2) vp += a.lower(p+n0*n1,2)*u(p+n0*n1);
+		}
+		v(p) = vp;
+	  }
+	}
+  }
+}
+
+//! Evaluates the residual r = b - A*u
+template<class T>
+void residual(const StencilMatrix<T> & a, const Vector<T> & u,
+			  const Vector<T> & b, Vector<T> & r)
+{
+  prod(a, u, r);
+  for(Index p=0; p<r.size(); ++p)
+	r(p) = b(p) - r(p);
+}
+
+}}//::numlib::linalg
+
+#endif
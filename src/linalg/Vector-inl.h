@@ -4,6 +4,7 @@
 template<class T>
 Vector<T>::Vector(Size n_):
 	n(n_),
+	cap(n_),
 	data(NULL)
 {
 	data = new T[n];
@@ -13,6 +14,7 @@ template<class T>
 Vector<T>::Vector(const Vector & other)
 {
 	n = other.n;
+	cap = n;
 	data = new T[n];
 	for(Index i=0; i<n; ++i)
 		data[i] = other.data[i];
@@ -29,9 +31,13 @@ Vector<T> & Vector<T>::operator=(const Vector & other)
 {
   if(&other==this) return *this;
 
-  delete[] data;
+  if(other.n > cap)
+  {
+	  delete[] data;
+	  cap = other.n;
+	  data = new T[cap];
+  }
   n = other.n;
-  data = new T[n];
   for(Index i=0; i<n; ++i)
 	  data[i] = other.data[i];
   return *this;
@@ -45,6 +51,22 @@ void Vector<T>::zero()
   	data[i] = z;
 }
 
+template<class T> inline
+void Vector<T>::swap(Vector & other)
+{
+	Size n_tmp = n;
+	n = other.n;
+	other.n = n_tmp;
+
+	Size cap_tmp = cap;
+	cap = other.cap;
+	other.cap = cap_tmp;
+
+	T* data_tmp = data;
+	data = other.data;
+	other.data = data_tmp;
+}
+
 template<class T> inline
 Size Vector<T>::size() const
 {
@@ -54,9 +76,19 @@ Size Vector<T>::size() const
 template<class T>
 void Vector<T>::resize(Size n_)
 {
-	delete[] data;
+	if(n_ > cap)
+	{
+		delete[] data;
+		cap = n_;
+		data = new T[cap];
+	}
 	n = n_;
-	data = new T[n];
+}
+
+template<class T> inline
+Size Vector<T>::capacity() const
+{
+  return cap;
 }
 
 template<class T> inline
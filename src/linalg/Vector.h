@@ -28,11 +28,17 @@ public:
    ~Vector();
 
    //! Assignment (deep copy)
+   /*!
+	*  Existing memory is reused when it can hold the other vector.
+	*/
    Vector & operator=(const Vector & other);
 
    //! Sets all elements to zero
    void zero();
 
+   //! Exchanges contents with other vector (no element copies)
+   void swap(Vector & other);
+
    /* Container interface */
 
    Size size() const;
@@ -40,10 +46,14 @@ public:
    //! Resizes vector to hold n elements
    /*!
 	*  Original contents may be destroyed. Resize operation is provided to
-	*  facilitate initialization of default constructed vectors.
+	*  facilitate initialization of default constructed vectors. Memory is
+	*  only reallocated if the new size exceeds the capacity.
 	*/
    void resize(Size n_);
 
+   //! Returns the number of elements the vector can hold without reallocation
+   Size capacity() const;
+
    T & operator()(Index i);
 
    const T & operator()(Index i) const;
@@ -62,6 +72,9 @@ private:
 
    //! Size
    Size n;
+
+   //! Allocated length of the element array
+   Size cap;
   
    //! element array
    T* data;
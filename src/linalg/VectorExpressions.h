@@ -142,6 +142,15 @@ Vector<T> operator-(const Vector<T> & u, const Vector<T> & v)
   return tmp;
 }
 
+//! Computes v += a*u in place (no temporary vector)
+template<class T> inline
+void axpy(const T & a, const Vector<T> & u, Vector<T> & v)
+{
+  ASSERT( u.size() == v.size() );
+  for(Index i=0; i<u.size(); ++i)
+	v(i) += a*u(i);
+}
+
 template<class T>
 T prod(const Vector<T> & u, const Vector<T> & v)
 {
@@ -0,0 +1,348 @@
+/*! \file CachedCostFunction.h
+ *  \brief CachedCostFunction class template definition
+ */
+
+#ifndef CACHED_COST_FUNCTION_H
+#define CACHED_COST_FUNCTION_H
+
+#include <cmath>
+#include <cstring>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/parallel_tools.h"
+#include "../array/Array1D.h"
+
+namespace numlib{ namespace optimization{
+
+//! Access to the components of the design (see CachedCostFunction)
+/*!
+ *	The default implementation is for vector types with size() and
+ *	operator()(i); the specialization for Real is for 1D cost functions.
+ */
+template<class X>
+struct CacheKeyTraits
+{
+	static Size size(const X& x) {return x.size();}
+
+	static Real component(const X& x, Index i) {return x(i);}
+};
+
+template<>
+struct CacheKeyTraits<Real>
+{
+	static Size size(const Real&) {return 1;}
+
+	static Real component(const Real& x, Index) {return x;}
+};
+
+//! Memoizing wrapper for 1D and ND cost functions
+/*!
+ *	Returns the cost of previously evaluated designs from a bounded cache,
+ *	and evaluates (and caches) the cost of other designs with the wrapped
+ *	function f. X is the type of the design: Real for 1D cost functions
+ *	(e.g. with OptimizerBGQ), or a vector type for ND cost functions (e.g.
+ *	with OptimizerPSO). Since the wrapper has the same interface as the
+ *	wrapped function, it may be used as the cost function template argument
+ *	of any optimizer. Gradients, f(x, grad), are forwarded to f, and are
+ *	not cached.
+ *
+ *	Designs are matched exactly, or, if a resolution h > 0 is given, after
+ *	rounding each component to the nearest multiple of h; i.e. designs
+ *	within h/2 of each other (component wise) may share an entry. This is
+ *	useful when an optimizer revisits a design up to round off (e.g. line
+ *	searches, or converged particles). The cache holds at most capacity
+ *	entries; once full, the least recently used entry is replaced. All
+ *	storage is allocated at construction; entries are located through a
+ *	hash table (FNV-1a hash of the rounded components).
+ *
+ *	The wrapper may be called concurrently (provided f may). The cache is
+ *	guarded by a Mutex, which is not held while f is evaluated; thus,
+ *	concurrent calls with the same new design may both evaluate f.
+ *
+ *	The cache assumes f does not change; call clear() if it does (e.g. when
+ *	wrapping a LineRestriction, whose line changes every iteration).
+ *
+ *	This object holds a reference to f for the duration of its life. Do not
+ *	delete f prior to the deletion of this object.
+ */
+template<class F, class X>
+class CachedCostFunction
+{
+public:
+
+	typedef F FunctionType;
+	typedef X VectorType;
+
+	//! Wraps f, of a design with dim components
+	/*!
+	 *	Arguments:
+	 *	  f_: cost function
+	 *	  dim_: number of design variables (1 for 1D cost functions)
+	 *	  capacity_: maximum number of cached entries
+	 *	  h_: resolution (0 for exact matching)
+	 */
+	CachedCostFunction(FunctionType& f_, Size dim_, Size capacity_=1024, Real h_=0.0):
+		f(f_), dim(dim_), cap(capacity_), h(h_), nb(numBuckets(capacity_)), none(capacity_),
+		keys(capacity_*dim_), vals(capacity_), hashes(capacity_), bucket(nb),
+		chain(capacity_), older(capacity_), newer(capacity_), nhit(0), nmiss(0)
+	{
+		ASSERT( cap > 0 );
+		ASSERT( not (h < 0) );
+
+		clear();
+	}
+
+	//! Returns the cost at x
+	Real operator()(const VectorType& x)
+	{
+		ASSERT( Traits::size(x) == dim );
+
+		const unsigned long hx = hash(x);
+
+		{
+			ScopedLock lock(mutex);
+
+			const Index e = find(x, hx);
+
+			if(e != none)
+			{
+				++nhit;
+				touch(e);
+				return vals(e);
+			}
+
+			++nmiss;
+		}
+
+		const Real fx = f(x);
+
+		ScopedLock lock(mutex);
+
+		insert(x, hx, fx);
+
+		return fx;
+	}
+
+	//! Computes the gradient at x (not cached)
+	void operator()(const VectorType& x, VectorType& grad) {f(x, grad);}
+
+	//! Returns the number of design variables (1 for 1D cost functions)
+	Size size() const {return dim;}
+
+	//! Returns the number of cached entries
+	Size entries() const {return nused;}
+
+	//! Returns the maximum number of cached entries
+	Size capacity() const {return cap;}
+
+	//! Returns the resolution used to match designs
+	Real resolution() const {return h;}
+
+	//! Returns the number of calls answered from the cache
+	Size hits() const {return nhit;}
+
+	//! Returns the number of calls which evaluated f
+	Size misses() const {return nmiss;}
+
+	//! Resets hit and miss counts
+	void resetStatistics()
+	{
+		nhit = 0;
+		nmiss = 0;
+	}
+
+	//! Removes all entries (statistics are retained)
+	void clear()
+	{
+		nused = 0;
+		lru = none;
+		mru = none;
+		for(Index b=0; b<nb; ++b)
+			bucket(b) = none;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( CachedCostFunction );
+
+	typedef CacheKeyTraits<VectorType> Traits;
+
+	//! Reference to cost function
+	FunctionType& f;
+
+	//! Number of design variables
+	Size dim;
+
+	//! Maximum number of entries
+	Size cap;
+
+	//! Resolution
+	Real h;
+
+	//! Number of hash buckets (a power of 2)
+	Size nb;
+
+	//! Null entry index
+	const Index none;
+
+	//! Rounded designs (dim per entry) and costs of the entries
+	array::Array1D<Real> keys, vals;
+
+	//! Hash of each entry
+	array::Array1D<unsigned long> hashes;
+
+	//! First entry of each bucket, and next entry of the same bucket
+	array::Array1D<Index> bucket, chain;
+
+	//! Neighbors of each entry in order of use
+	array::Array1D<Index> older, newer;
+
+	//! Number of entries
+	Size nused;
+
+	//! Least and most recently used entries
+	Index lru, mru;
+
+	//! Statistics
+	Size nhit, nmiss;
+
+	//! Guards the cache and statistics
+	Mutex mutex;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Returns the smallest power of 2 not less than twice the capacity
+	static Size numBuckets(Size capacity)
+	{
+		Size n = 1;
+		while(n < 2*capacity) n *= 2;
+		return n;
+	}
+
+	// Returns component i of x, rounded to the resolution
+	Real key(const VectorType& x, Index i) const
+	{
+		const Real xi = Traits::component(x, i);
+		const Real ki = (h > 0) ? std::floor(xi/h + 0.5) : xi;
+		return (ki == 0) ? 0.0 : ki; /* -0 and +0 match */
+	}
+
+	// Returns FNV-1a hash of the rounded components of x
+	unsigned long hash(const VectorType& x) const
+	{
+		unsigned long hx = 2166136261UL;
+
+		unsigned char bytes[sizeof(Real)];
+		for(Index i=0; i<dim; ++i)
+		{
+			const Real ki = key(x, i);
+			std::memcpy(bytes, &ki, sizeof(Real));
+			for(Index b=0; b<sizeof(Real); ++b)
+			{
+				hx ^= bytes[b];
+				hx = (hx*16777619UL) & 0xffffffffUL;
+			}
+		}
+
+		return hx;
+	}
+
+	// Returns the entry matching x, or none
+	Index find(const VectorType& x, unsigned long hx) const
+	{
+		for(Index e=bucket(hx & (nb-1)); e!=none; e=chain(e))
+		{
+			if(hashes(e) != hx) continue;
+
+			Index i = 0;
+			while( (i < dim) and (keys(e*dim+i) == key(x, i)) ) ++i;
+
+			if(i == dim) return e;
+		}
+
+		return none;
+	}
+
+	// Adds (x, fx), replacing the least recently used entry if full
+	void insert(const VectorType& x, unsigned long hx, Real fx)
+	{
+		Index e = find(x, hx); /* inserted by a concurrent call? */
+
+		if(e != none)
+		{
+			touch(e);
+			return;
+		}
+
+		if(nused < cap)
+		{
+			e = nused++;
+		}
+		else
+		{
+			e = lru;
+			unlink(e);
+			removeFromBucket(e);
+		}
+
+		for(Index i=0; i<dim; ++i)
+			keys(e*dim+i) = key(x, i);
+		vals(e) = fx;
+		hashes(e) = hx;
+
+		const Index b = hx & (nb-1);
+		chain(e) = bucket(b);
+		bucket(b) = e;
+
+		pushMostRecent(e);
+	}
+
+	// Marks entry e most recently used
+	void touch(Index e)
+	{
+		if(e == mru) return;
+
+		unlink(e);
+		pushMostRecent(e);
+	}
+
+	// Removes entry e from the order of use
+	void unlink(Index e)
+	{
+		if(older(e) != none) newer(older(e)) = newer(e); else lru = newer(e);
+		if(newer(e) != none) older(newer(e)) = older(e); else mru = older(e);
+	}
+
+	// Appends entry e to the order of use
+	void pushMostRecent(Index e)
+	{
+		older(e) = mru;
+		newer(e) = none;
+
+		if(mru != none) newer(mru) = e; else lru = e;
+		mru = e;
+	}
+
+	// Removes entry e from its bucket
+	void removeFromBucket(Index e)
+	{
+		const Index b = hashes(e) & (nb-1);
+
+		if(bucket(b) == e)
+		{
+			bucket(b) = chain(e);
+			return;
+		}
+
+		Index p = bucket(b);
+		while(chain(p) != e) p = chain(p);
+		chain(p) = chain(e);
+	}
+
+};
+
+}}//::numlib::optimization
+
+#endif
@@ -0,0 +1,89 @@
+/*! \file GradientAD.h
+ *  \brief GradientAD template definition.
+ */
+
+#ifndef GRADIENT_AD_H
+#define GRADIENT_AD_H
+
+#include "../base/numlib-config.h"
+#include "../base/Dual.h"
+#include "../linalg/Vector.h"
+
+namespace numlib{ namespace optimization{
+
+//! Exact gradient of a cost function by forward mode automatic differentiation
+/*!
+ *  Models the gradient function, GradF, of CostFunctionND; i.e.
+ *  gradf(x, grad). The cost function, f, must implement its call operator
+ *  as a template on the numeric type, so that it may be evaluated with
+ *  both T and Dual<T,N> vectors; i.e.
+ *
+ *     template<class S>
+ *     S operator()(const linalg::Vector< S > & x);
+ *
+ *  The gradient is computed N components at a time; thus, an evaluation of
+ *  the gradient requires ceil(n/N) evaluations of f with Dual<T,N>
+ *  arithmetic. Only a reference to f is held, so copies of this object (as
+ *  made by CostFunctionND) share the same cost function.
+ *
+ *  Template arguments:
+ *  T.... Numeric type (e.g. numlib::Real)
+ *  F.... Cost function type
+ *  N.... Number of gradient components per evaluation
+ */
+template<class T, class F, Size N=4>
+class GradientAD
+{
+public:
+
+	typedef linalg::Vector<T> VecType;
+
+	typedef Dual<T,N> DualType;
+
+	typedef linalg::Vector<DualType> DualVecType;
+
+	GradientAD(F& f_): f(f_), xd(0) {}
+
+	//! Computes the gradient of f at x
+	void operator()(const VecType& x, VecType& grad)
+	{
+		const Size n = x.size();
+
+		ASSERT( grad.size() == n );
+
+		if(xd.size() != n) xd.resize(n);
+
+		for(Index i=0; i<n; ++i)
+			xd(i) = DualType(x(i));
+
+		for(Index i0=0; i0<n; i0+=N)
+		{
+			const Size m = min(N, n - i0);
+
+			// Seed components i0,...,i0+m-1...
+			for(Index k=0; k<m; ++k)
+				xd(i0+k).derivative(k) = T(1);
+
+			DualType fx = f(xd);
+
+			for(Index k=0; k<m; ++k)
+			{
+				grad(i0+k) = fx.derivative(k);
+				xd(i0+k).derivative(k) = T(0);
+			}
+		}
+	}
+
+private:
+
+	//! Cost function
+	F& f;
+
+	//! Work vector holding the seeded dual argument
+	DualVecType xd;
+
+};
+
+}}//::numlib::optimization
+
+#endif
@@ -0,0 +1,118 @@
+/*! \file GradientCS.h
+ *  \brief GradientCS template definition.
+ */
+
+#ifndef GRADIENT_CS_H
+#define GRADIENT_CS_H
+
+#include <complex>
+#include <vector>
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/parallel_tools.h"
+#include "../linalg/Vector.h"
+
+namespace numlib{ namespace optimization{
+
+//! Gradient of a cost function by the complex step method
+/*!
+ *  Models the gradient function, GradF, of CostFunctionND; i.e.
+ *  gradf(x, grad). Component i of the gradient is
+ *
+ *     Im[f(x + i*h*e_i)]/h + O(h^2)
+ *
+ *  which, unlike finite differences, is free of subtractive cancellation;
+ *  thus, h may be tiny (1e-20 by default), and the gradient is accurate to
+ *  round-off (Squire, W., G. Trapp. "Using Complex Variables to Estimate
+ *  Derivatives of Real Functions." SIAM Review. Vol. 40, No. 1, pp.
+ *  110-112, 1998). As for GradientAD, the cost function must implement its
+ *  call operator as a template on the numeric type; i.e.
+ *
+ *     template<class S>
+ *     S operator()(const linalg::Vector< S > & x);
+ *
+ *  and must be analytic in the real sense (e.g. abs must not be applied to
+ *  a complex argument). The gradient requires n evaluations of f with
+ *  complex arithmetic, which are done concurrently in parallel mode (see
+ *  parallelEvaluation); the cost function must then be safe to call
+ *  concurrently.
+ *
+ *  Template arguments:
+ *  T.... Numeric type (e.g. numlib::Real)
+ *  F.... Cost function type
+ */
+template<class T, class F>
+class GradientCS
+{
+public:
+
+	typedef linalg::Vector<T> VecType;
+
+	typedef std::complex<T> ComplexType;
+
+	typedef linalg::Vector<ComplexType> ComplexVecType;
+
+	GradientCS(F& f_): f(f_), h(1.0E-20), par(false) {}
+
+	//! Sets the (imaginary) step
+	void step(T h_)
+	{
+		ASSERT( h_ > 0 );
+		h = h_;
+	}
+
+	//! Returns the (imaginary) step
+	T step() const {return h;}
+
+	//! Enables/disables concurrent evaluation of the perturbed costs
+	void parallelEvaluation(bool par_) {par = par_;}
+
+	//! Returns true if the perturbed costs are evaluated concurrently
+	bool parallelEvaluation() const {return par;}
+
+	//! Computes the gradient of f at x
+	void operator()(const VecType& x, VecType& grad)
+	{
+		const Size n = x.size();
+		const Size nt = par ? maxThreads() : 1;
+
+		ASSERT( grad.size() == n );
+
+		if(work.size() != nt) work.resize(nt);
+		for(Index t=0; t<nt; ++t)
+		{
+			if(work[t].size() != n) work[t].resize(n);
+			for(Index i=0; i<n; ++i)
+				work[t](i) = ComplexType(x(i), T(0));
+		}
+
+		#pragma omp parallel for schedule(dynamic) if(par)
+		for(Index i=0; i<n; ++i)
+		{
+			ComplexVecType& xc = work[threadIndex()];
+
+			xc(i) = ComplexType(x(i), h);
+			grad(i) = std::imag(f(xc))/h;
+			xc(i) = ComplexType(x(i), T(0));
+		}
+	}
+
+private:
+
+	//! Cost function
+	F& f;
+
+	//! Imaginary step
+	T h;
+
+	//! Parallel evaluation flag
+	bool par;
+
+	//! Complex designs of each thread
+	std::vector<ComplexVecType> work;
+
+};
+
+}}//::numlib::optimization
+
+#endif
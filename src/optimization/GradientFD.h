@@ -0,0 +1,166 @@
+/*! \file GradientFD.h
+ *  \brief GradientFD template definition.
+ */
+
+#ifndef GRADIENT_FD_H
+#define GRADIENT_FD_H
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/parallel_tools.h"
+#include "../array/Array1D.h"
+
+namespace numlib{ namespace optimization{
+
+//! Finite difference gradient of a (black box) cost function
+/*!
+ *  Models the gradient function, GradF, of CostFunctionND; i.e.
+ *  gradf(x, grad). Only f(x) is required of the cost function. Component i
+ *  of the gradient is approximated by forward differences,
+ *
+ *     [f(x + h_i*e_i) - f(x)]/h_i + O(h_i),   h_i = sqrt(eps)*max(|x_i|, 1),
+ *
+ *  (n+1 evaluations of f), or by central differences,
+ *
+ *     [f(x + h_i*e_i) - f(x - h_i*e_i)]/(2*h_i) + O(h_i^2),
+ *
+ *  with h_i = cbrt(eps)*max(|x_i|, 1) (2n evaluations of f), where eps is
+ *  the relative error of f (machine epsilon by default; see
+ *  relativeError). These steps balance truncation and round-off error
+ *  (Nocedal, J., S.J. Wright. "Numerical Optimization." 2nd Ed., Sec. 8.1,
+ *  Springer, 2006). Each step is rounded such that x_i + h_i is exactly
+ *  representable.
+ *
+ *  In parallel mode (see parallelEvaluation) the perturbed evaluations are
+ *  done concurrently, each thread perturbing its own copy of x; the cost
+ *  function must then be safe to call concurrently. The result does not
+ *  depend on the number of threads.
+ *
+ *  Only a reference to f is held, so copies of this object (as made by
+ *  CostFunctionND) share the same cost function. Work vectors are allocated
+ *  on first use.
+ */
+template<class F, class V>
+class GradientFD
+{
+public:
+
+	typedef V VectorType;
+
+	//! Difference schemes
+	enum Scheme {FORWARD, CENTRAL};
+
+	GradientFD(F& f_, Scheme sch_=FORWARD):
+		f(f_), sch(sch_), eps(std::numeric_limits<Real>::epsilon()), par(false),
+		h(0), fpert(0)
+	{}
+
+	//! Sets the difference scheme
+	void scheme(Scheme sch_) {sch = sch_;}
+
+	//! Returns the difference scheme
+	Scheme scheme() const {return sch;}
+
+	//! Sets the relative error of the cost function (determines the steps)
+	void relativeError(Real eps_)
+	{
+		ASSERT( eps_ > 0 );
+		eps = eps_;
+	}
+
+	//! Enables/disables concurrent evaluation of the perturbed costs
+	void parallelEvaluation(bool par_) {par = par_;}
+
+	//! Returns true if the perturbed costs are evaluated concurrently
+	bool parallelEvaluation() const {return par;}
+
+	//! Computes the gradient of f at x
+	void operator()(const VectorType& x, VectorType& grad)
+	{
+		const Size n = x.size();
+		const Size m = (sch == FORWARD) ? n+1 : 2*n;
+		const Size nt = par ? maxThreads() : 1;
+
+		ASSERT( grad.size() == n );
+
+		// Compute steps...
+
+		if(h.size() != n) h.resize(n);
+		if(fpert.size() != m) fpert.resize(m);
+
+		const Real r = (sch == FORWARD) ? std::sqrt(eps) : std::pow(eps, 1.0/3.0);
+
+		for(Index i=0; i<n; ++i)
+		{
+			const Real xi = x(i);
+			volatile Real xh = xi + r*max(std::fabs(xi), 1.0);
+			h(i) = xh - xi;
+		}
+
+		// Evaluate perturbed costs (the last, for FORWARD, is f(x))...
+
+		if(work.size() != nt) work.resize(nt);
+		for(Index t=0; t<nt; ++t)
+			work[t] = x;
+
+		#pragma omp parallel for schedule(dynamic) if(par)
+		for(Index k=0; k<m; ++k)
+		{
+			VectorType& xp = work[threadIndex()];
+
+			if(k == n and sch == FORWARD)
+			{
+				fpert(k) = f(xp);
+				continue;
+			}
+
+			const Index i = (sch == FORWARD) ? k : k/2;
+			const Real hk = (k%2 == 1 and sch == CENTRAL) ? -h(i) : h(i);
+
+			xp(i) = x(i) + hk;
+			fpert(k) = f(xp);
+			xp(i) = x(i);
+		}
+
+		// Differences...
+
+		for(Index i=0; i<n; ++i)
+		{
+			if(sch == FORWARD)
+				grad(i) = (fpert(i) - fpert(n))/h(i);
+			else
+				grad(i) = (fpert(2*i) - fpert(2*i+1))/(2.0*h(i));
+		}
+	}
+
+private:
+
+	//! Cost function
+	F& f;
+
+	//! Difference scheme
+	Scheme sch;
+
+	//! Relative error of f
+	Real eps;
+
+	//! Parallel evaluation flag
+	bool par;
+
+	//! Steps of each component
+	array::Array1D<Real> h;
+
+	//! Perturbed costs
+	array::Array1D<Real> fpert;
+
+	//! Perturbed designs of each thread
+	std::vector<VectorType> work;
+
+};
+
+}}//::numlib::optimization
+
+#endif
@@ -0,0 +1,131 @@
+/*! \file HessianFD.h
+ *  \brief HessianFD template definition
+ */
+
+#ifndef HESSIAN_FD_H
+#define HESSIAN_FD_H
+
+#include <cmath>
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/nocopy.h"
+#include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
+
+namespace numlib{ namespace optimization{
+
+//! Hessian-vector product of a cost function by finite differences
+/*!
+ *  Approximates the product of the Hessian of f at x with a vector v by a
+ *  forward difference of the gradient of f,
+ *
+ *     H(x)*v ~ [grad f(x + h*v) - grad f(x)]/h
+ *
+ *  where the step size, h, is chosen as for solver::GateauxFD. Each product
+ *  requires one gradient evaluation; the Hessian is never formed. This is a
+ *  linear operator (see linalg/LinearOperator.h), and may be used with the
+ *  Krylov solvers, or with OptimizerTN.
+ *
+ *  The cost function type implements the gradient interface of
+ *  CostFunctionND; i.e. f(x, grad).
+ */
+template<class CostFunction>
+class HessianFD
+{
+public:
+
+	typedef typename CostFunction::VectorType VectorType;
+
+	HessianFD(CostFunction& f_, Size n):
+		eps(1.0E-9), f(f_), x(0), g(0), xpert(n)
+	{
+		eps = std::sqrt(eps);
+	}
+
+	~HessianFD() { /* nothing to delete */ }
+
+	//! Sets the evaluation point of the Hessian by reference
+	/*!
+	 *  x := Point at which the Hessian is evaluated
+	 *  g := Gradient of f at x
+	 *
+	 *  WARNING: Only references to x and g are stored (x and g are not
+	 *  copied)! Both vectors must remain valid, and unmodified, for as long
+	 *  as this operator is evaluated at this point.
+	 */
+	void bind(const VectorType& x_, const VectorType& g_)
+	{
+		ASSERT( x_.size() == xpert.size() );
+		ASSERT( g_.size() == xpert.size() );
+		x = &x_;
+		g = &g_;
+	}
+
+	//! Evaluates the Hessian-vector product, hv = H(x)*v
+	void eval(const VectorType& v, VectorType& hv) const
+	{
+		ASSERT( x != 0 );
+		ASSERT( v.size() == hv.size() );
+		ASSERT( &v != &hv );
+
+		// Compute step size...
+
+		Real xTv = prod(*x, v);
+		Real xTv_sign = (xTv < 0) ? -1.0 : 1.0;
+		Real vn = norm2(v);
+
+		ASSERT( vn > 0 );
+
+		Real h = (eps/vn)*max(std::fabs(xTv), eps)*xTv_sign;
+
+		// Evaluate finite difference of gradient...
+
+		xpert  = v;
+		xpert *= h;
+		xpert += *x;
+		f(xpert, hv); /* hv = grad f(x+h*v) */
+
+		hv -= *g;
+		hv /= h;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( HessianFD );
+
+	//! Approximate round-off error in the evaluation of the gradient
+	Real eps;
+
+	//! Cost function
+	CostFunction& f;
+
+	//! Point at which the Hessian is evaluated
+	const VectorType* x;
+
+	//! Gradient at x
+	const VectorType* g;
+
+	//! Work vector holding the perturbed point x + h*v
+	mutable VectorType xpert;
+
+};
+
+//! Linear operator wrapper function for HessianFD
+template<class CostFunction, class T> inline
+linalg::Vector<T> prod(const HessianFD<CostFunction>& hess, const linalg::Vector<T>& v)
+{
+	linalg::Vector<T> hv(v.size());
+	hess.eval(v, hv);
+	return hv;
+}
+
+//! In-place linear operator wrapper function for HessianFD
+template<class CostFunction, class T> inline
+void prodIP(const HessianFD<CostFunction>& hess, const linalg::Vector<T>& v, linalg::Vector<T>& hv)
+{
+	hess.eval(v, hv);
+}
+
+}}//::numlib::optimization
+
+#endif
@@ -0,0 +1,193 @@
+/*! \file KSection.h
+ *  \brief KSection template definition
+ */
+
+#ifndef K_SECTION_H
+#define K_SECTION_H
+
+#include "../base/numlib-config.h"
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../array/Array1D.h"
+
+#include "optimization_error_codes.h"
+#include "Minimum1D.h"
+
+namespace numlib{ namespace optimization{
+
+//! 1D optimizer based on parallel k-section search
+/*!
+ *	Parallel counterpart of GoldenSection. Each round divides the current
+ *	interval [a, b] into k+1 equal subintervals, and evaluates the cost at
+ *	the k interior points concurrently; the new interval is formed by the
+ *	neighbors of the lowest point (including the current estimate of the
+ *	optimum). When k is odd, the current estimate is the midpoint of the
+ *	interval after the first round, and is reused; thus, each round costs
+ *	k-1 new evaluations, and reduces the interval by a factor of (k+1)/2
+ *	(e.g. 4 for k = 7, in one round of concurrent evaluations, versus 1.618
+ *	per evaluation for GoldenSection). When k is even, all k points are
+ *	evaluated each round. At least 2 points are required.
+ *
+ *	The interval is reduced until its length is less than the reduction
+ *	ratio times its initial length. Upon input, min must hold a bracket
+ *	(e.g. as set by BracketFinder or ParallelBracketFinder); upon output, it
+ *	holds the reduced bracket. The cost function must be safe to call
+ *	concurrently.
+ *
+ *	Template parameter CostFunction may be any callable class
+ *	or function pointer.
+ */
+template<class CostFunction>
+class KSection
+{
+public:
+
+	KSection(Real reduction_ratio, Size k_=3):
+		rr(reduction_ratio), k(k_), xs(k_+3), fs(k_+3), eval(k_+3)
+	{
+		ASSERT( k > 1 );
+	}
+
+	void reductionRatio(Real reduction_ratio) {rr = reduction_ratio;}
+
+	Real reductionRatio() const {return rr;}
+
+	//! Sets number of interior points per round (at least 2)
+	void points(Size k_)
+	{
+		ASSERT( k_ > 1 );
+		k = k_;
+		xs.resize(k+3);
+		fs.resize(k+3);
+		eval.resize(k+3);
+	}
+
+	//! Returns number of interior points per round
+	Size points() const {return k;}
+
+	ErrorCode minimize(CostFunction& f, Minimum1D& min)
+	{
+		// Initialize bounds and optimum estimate...
+
+		Real a = min.lowerBound();
+		Real b = min.upperBound();
+
+		Real fa = min.costAtLowerBound();
+		Real fb = min.costAtUpperBound();
+
+		Real xm = min.design();
+		Real fm = min.cost();
+
+		const Real len_stop = rr*(b - a);
+
+		bool centered = false;
+
+		while(b - a > len_stop)
+		{
+			const Real h = (b - a)/(k + 1);
+
+			// Set up interior points (reusing the estimate if at the midpoint)...
+
+			Size n = k + 2;
+
+			xs(0) = a;
+			fs(0) = fa;
+			eval(0) = false;
+
+			for(Index j=1; j<=k; ++j)
+			{
+				xs(j) = a + j*h;
+				eval(j) = true;
+			}
+
+			xs(k+1) = b;
+			fs(k+1) = fb;
+			eval(k+1) = false;
+
+			if(centered and (k%2 == 1))
+			{
+				const Index c = (k + 1)/2;
+				xs(c) = xm;
+				fs(c) = fm;
+				eval(c) = false;
+			}
+
+			// Evaluate costs...
+
+			#pragma omp parallel for schedule(dynamic)
+			for(int j=1; j<=int(k); ++j)
+				if(eval(j)) fs(j) = f(xs(j));
+
+			// Insert estimate if not already a point...
+
+			Index ins = n;
+			if( not (centered and (k%2 == 1)) and (xm > a) and (xm < b) )
+			{
+				ins = 1;
+				while(xs(ins) < xm) ++ins;
+
+				if(xs(ins) == xm)
+				{
+					ins = n;
+				}
+				else
+				{
+					for(Index j=n; j>ins; --j)
+					{
+						xs(j) = xs(j-1);
+						fs(j) = fs(j-1);
+					}
+					xs(ins) = xm;
+					fs(ins) = fm;
+					++n;
+				}
+			}
+
+			// Locate lowest interior point, and reduce bounds...
+
+			Index jm = 1;
+			for(Index j=2; j+1<n; ++j)
+				if(fs(j) < fs(jm))
+					jm = j;
+
+			a  = xs(jm-1);
+			fa = fs(jm-1);
+			b  = xs(jm+1);
+			fb = fs(jm+1);
+			xm = xs(jm);
+			fm = fs(jm);
+
+			centered = (ins == n) or ( (jm != ins) and (jm+1 != ins) and (jm != ins+1) );
+		}
+
+		ASSERT( !(fm > fa) );
+		ASSERT( !(fm > fb) );
+
+		min.lowerBound(a, fa);
+		min.upperBound(b, fb);
+		min.design(xm, fm);
+
+		return SUCCESS;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( KSection );
+
+	// Require interval reduction ratio
+	Real rr;
+
+	// Number of interior points per round
+	Size k;
+
+	// Points of the current round (including bounds), and their costs
+	array::Array1D<Real> xs, fs;
+
+	// Flags points to be evaluated
+	array::Array1D<bool> eval;
+
+};
+
+}}//::numlib::optimization
+
+#endif
@@ -5,6 +5,7 @@
 #ifndef LINE_RESTRICTION_H
 #define LINE_RESTRICTION_H
 
+#include "../base/debug_tools.h"
 #include "CostFunctionND.h"
 
 namespace numlib{ namespace optimization{
@@ -21,6 +22,12 @@ namespace numlib{ namespace optimization{
  *  	x := reference position in the n-dimensional design space
  *  	s := search direction in the n-dimensional design space
  *
+ *  The point x + alpha*s is formed in place in a scratch vector owned by
+ *  the restriction (allocated at construction); thus, evaluations do not
+ *  allocate. If the cost function also supplies its gradient (i.e.
+ *  f(x, grad), as CostFunctionND), the derivative of the restriction,
+ *  phi'(alpha) = grad f(x + alpha*s)*s, is also available (see derivative);
+ *  the gradient work vector is allocated upon the first such evaluation.
  */
 template<class CostFunction >
 class LineRestriction
@@ -45,11 +52,37 @@ public:
 	 *  search.
 	 */
 	LineRestriction(CostFunction& f_, const VectorType& pos, const VectorType& dir):
-		f(f_), x(pos), s(dir)
+		f(f_), x(pos), s(dir), xa(pos.size()), ga(0)
 	{}
 
 	// Evaluates the restriction of f to the line x + alpha*s
-	Real operator()(Real alpha) {return f(x + alpha*s);}
+	Real operator()(Real alpha)
+	{
+		setPoint(alpha);
+		return f(xa);
+	}
+
+	// Evaluates the restriction, phi(alpha), and its derivative, dphi
+	Real operator()(Real alpha, Real& dphi)
+	{
+		setPoint(alpha);
+		const Real fa = f(xa);
+		dphi = gradient();
+		return fa;
+	}
+
+	// Evaluates the derivative of the restriction, phi'(alpha)
+	Real derivative(Real alpha)
+	{
+		setPoint(alpha);
+		return gradient();
+	}
+
+	// Returns the point, x + alpha*s, of the last evaluation
+	const VectorType& point() const {return xa;}
+
+	// Returns the gradient of f at the point of the last derivative evaluation
+	const VectorType& pointGradient() const {return ga;}
 
 private:
 
@@ -64,6 +97,29 @@ private:
 	// Reference to search direction vector
 	const VectorType& s;
 
+	// Scratch vector holding x + alpha*s
+	VectorType xa;
+
+	// Gradient of f at xa
+	VectorType ga;
+
+	// Sets xa = x + alpha*s
+	void setPoint(Real alpha)
+	{
+		ASSERT( x.size() == xa.size() );
+		ASSERT( s.size() == xa.size() );
+		for(Index i=0; i<xa.size(); ++i)
+			xa(i) = x(i) + alpha*s(i);
+	}
+
+	// Evaluates the gradient at xa, and returns its projection on s
+	Real gradient()
+	{
+		if(ga.size() != xa.size()) ga.resize(xa.size());
+		f(xa, ga);
+		return prod(ga, s);
+	}
+
 };
 
 }}//::numlib::optimization
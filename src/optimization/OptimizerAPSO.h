@@ -0,0 +1,433 @@
+/*! \file OptimizerAPSO.h
+ *  \brief OptimizerAPSO class template definition
+ */
+
+#ifndef OPTIMIZER_APSO_H
+#define OPTIMIZER_APSO_H
+
+#include <cmath>
+#include <vector>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/parallel_tools.h"
+#include "../base/random.h"
+#include "../array/Array1D.h"
+
+#include "optimization_error_codes.h"
+#include "MinimumND.h"
+
+namespace numlib{ namespace optimization{
+
+//! Asynchronous Particle Swarm Optimization (PSO)
+/*!
+ *	Implements the particle model of Particle (and the parameters of
+ *	OptimizerPSO), but without iterations: each thread repeatedly claims
+ *	a particle which is not being evaluated, moves it relative to the
+ *	current global best, evaluates its cost, and then updates the personal
+ *	and global best; the thread then immediately claims another particle.
+ *	Thus, no thread waits for the slowest evaluation of a generation, as
+ *	in the parallel mode of OptimizerPSO. This pays off when evaluation
+ *	times vary widely (e.g. simulation based cost functions). Particles
+ *	are claimed in round robin order, skipping those being evaluated. The
+ *	cost function must be safe to call concurrently.
+ *
+ *	Claims and updates are serialized by a Mutex; the cost evaluations,
+ *	and particle moves, are not. Each claim draws the random numbers of the
+ *	particle and copies the global best (O(dim) work under the lock).
+ *
+ *	The optimization terminates once the global best has not improved by
+ *	more than the tolerance in max_count*np consecutive evaluations (cf.
+ *	OptimizerPSO::minimize), or after max_iter*np evaluations.
+ *
+ *	Since the order of claims and updates depends on the thread schedule,
+ *	the result of an asynchronous run is not reproducible. For debugging,
+ *	the order may be recorded (see recordSchedule), and later replayed,
+ *	serially, by a run with the same seed (see replaySchedule); provided
+ *	that the cost function is deterministic, the replay reproduces the
+ *	recorded run exactly. With one thread, runs are always reproducible.
+ */
+template<class F, class V>
+class OptimizerAPSO
+{
+public:
+
+	typedef F FunctionType;
+	typedef V VectorType;
+	typedef MinimumND<VectorType> Minimum;
+
+	//! Sequence of claims (particle index i) and updates (np + i)
+	typedef std::vector<Index> Schedule;
+
+	OptimizerAPSO(Size dim_, Size np_, Real tol_=5.0E-3, Size max_count_=10, Size max_iter_=1000):
+		dim(dim_), np(np_), tol(tol_), max_count(max_count_), max_iter(max_iter_),
+		vmax(0.5), w(0.0), c1(1.5), c2(2.5), rseed(1), record(false), replay(false),
+		pos(new VectorType[np_]), vel(new VectorType[np_]), pbest_pos(new VectorType[np_]),
+		cst(np_), pbest_cst(np_), r1(np_), r2(np_), busy(np_), gbest_pos(dim_), gbest_cst(0),
+		gt(0), ngt(0), next(0), neval(0), nclaim(0), stall(0)
+	{
+		ASSERT( np > 0 );
+
+		for(Index i=0; i<np; ++i)
+		{
+			pos[i].resize(dim);
+			vel[i].resize(dim);
+			pbest_pos[i].resize(dim);
+		}
+
+		threadWork(maxThreads());
+	}
+
+	~OptimizerAPSO()
+	{
+		delete[] pos;
+		delete[] vel;
+		delete[] pbest_pos;
+		delete[] gt;
+	}
+
+	//! Returns the number of particles
+	Size size() const {return np;}
+
+	//! Sets the inertia of each particle (see Particle::inertia)
+	void inertia(const Real w_) {w = w_;}
+
+	//! Sets maximum velocity of each particle
+	void maxVelocity(const Real vmax_) {vmax = vmax_;}
+
+	//! Sets confidence of each particle in its own best
+	void selfTrust(const Real c1_) {c1 = c1_;}
+
+	//! Sets confidence of each particle in the global best
+	void swarmTrust(const Real c2_) {c2 = c2_;}
+
+	//! Sets the seed of the random number generator
+	void seed(unsigned long rseed_) {rseed = rseed_;}
+
+	//! Returns the seed of the random number generator
+	unsigned long seed() const {return rseed;}
+
+	//! Enables/disables recording of the schedule of subsequent runs
+	void recordSchedule(bool record_) {record = record_;}
+
+	//! Returns the schedule recorded by the last run (see recordSchedule)
+	const Schedule& schedule() const {return sched;}
+
+	//! Replays the given schedule, serially, in subsequent runs
+	void replaySchedule(const Schedule& sched_)
+	{
+		sched = sched_;
+		replay = true;
+	}
+
+	//! Returns to asynchronous runs (see replaySchedule)
+	void asynchronous() {replay = false;}
+
+	//! Returns the number of cost evaluations of the last run (excluding newSequence)
+	Size evaluations() const {return neval;}
+
+	//! Returns the personal best position of particle i
+	const VectorType& bestPosition(Index i) const {return pbest_pos[i];}
+
+	//! Returns the personal best cost of particle i
+	Real bestCost(Index i) const {return pbest_cst(i);}
+
+	//! Initializes particle positions and velocities, and evaluates their costs
+	/*!
+	 *	The swarm is centered about min.design(), as for OptimizerPSO. The
+	 *	initial costs are evaluated concurrently.
+	 */
+	ErrorCode newSequence(FunctionType& f, Minimum& min)
+	{
+		ASSERT( min.design().size() == dim );
+
+		rng.seed(rseed);
+
+		const VectorType& x0 = min.design();
+
+		for(Index j=0; j<np; ++j)
+		{
+			if(j == 0)
+			{
+				pos[j] = x0;
+			}
+			else
+			{
+				rng.vector(pos[j], -1.0, 1.0);
+				pos[j] += x0; /* center swarm about initial guess */
+			}
+			rng.vector(vel[j], -0.1, 0.1);
+			constrict(vel[j]);
+		}
+
+		#pragma omp parallel for schedule(dynamic)
+		for(Index j=0; j<np; ++j)
+			cst(j) = f(pos[j]);
+
+		Index g = 0;
+		for(Index j=0; j<np; ++j)
+		{
+			pbest_pos[j] = pos[j];
+			pbest_cst(j) = cst(j);
+			busy(j) = false;
+
+			if(pbest_cst(j) < pbest_cst(g)) g = j;
+		}
+
+		gbest_pos = pbest_pos[g];
+		gbest_cst = pbest_cst(g);
+		min.design(gbest_pos, gbest_cst);
+
+		next = 0;
+		neval = 0;
+		nclaim = 0;
+		stall = 0;
+
+		return SUCCESS;
+	}
+
+	//! Executes a complete optimization sequence
+	/*!
+	 *	Returns EXCEEDED_MAX_ITER if the evaluation limit was reached before
+	 *	the convergence criterion (see class description) was met.
+	 */
+	ErrorCode minimize(FunctionType& f, Minimum& min)
+	{
+		ErrorCode code = newSequence(f, min);
+
+		if(code!=SUCCESS) return code;
+
+		if(replay)
+			runSerial(f);
+		else
+			runAsync(f);
+
+		min.design(gbest_pos, gbest_cst);
+
+		return converged() ? SUCCESS : EXCEEDED_MAX_ITER;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( OptimizerAPSO );
+
+	//! Number of design variables
+	Size dim;
+
+	//! Number of particles
+	Size np;
+
+	Real tol;
+
+	Size max_count;
+
+	Size max_iter;
+
+	//! Particle parameters (see Particle)
+	Real vmax, w, c1, c2;
+
+	//! Seed of the random number generator
+	unsigned long rseed;
+
+	//! Schedule record and replay flags
+	bool record, replay;
+
+	//! Recorded (or replayed) schedule
+	Schedule sched;
+
+	//! Random number generator (drawn from under lock)
+	RandomGenerator rng;
+
+	//! Particle positions, velocities, and personal best positions
+	VectorType *pos, *vel, *pbest_pos;
+
+	//! Particle costs and personal best costs
+	array::Array1D<Real> cst, pbest_cst;
+
+	//! Random numbers of each particle (drawn when claimed)
+	array::Array1D<Real> r1, r2;
+
+	//! Flags particles being evaluated
+	array::Array1D<bool> busy;
+
+	//! Global best position and cost
+	VectorType gbest_pos;
+	Real gbest_cst;
+
+	//! Copy of the global best of each thread (taken when claiming)
+	VectorType* gt;
+
+	//! Number of thread copies of the global best
+	Size ngt;
+
+	//! Particle at which the next claim begins searching
+	Index next;
+
+	//! Number of completed evaluations and claims
+	Size neval, nclaim;
+
+	//! Number of consecutive evaluations without improvement
+	Size stall;
+
+	//! Guards all shared state except the particles being evaluated
+	Mutex mutex;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	bool converged() const {return stall >= max_count*np;}
+
+	// Ensures a copy of the global best is available to each of nt threads
+	void threadWork(Size nt)
+	{
+		if(nt <= ngt) return;
+
+		delete[] gt;
+		gt = new VectorType[nt];
+		for(Index t=0; t<nt; ++t)
+			gt[t].resize(dim);
+		ngt = nt;
+	}
+
+	// Each thread claims, moves, and evaluates particles until termination
+	void runAsync(FunctionType& f)
+	{
+		if(record) sched.clear();
+
+		const Size nt = numlib::min(maxThreads(), np);
+		threadWork(nt);
+
+		#pragma omp parallel num_threads(nt)
+		{
+			const Index t = threadIndex();
+
+			Index j = 0;
+			while(claimNext(j, gt[t]))
+			{
+				move(j, gt[t]);
+				const Real fj = f(pos[j]);
+				update(j, fj);
+			}
+		}
+	}
+
+	// Executes the claims and updates of the schedule in order
+	void runSerial(FunctionType& f)
+	{
+		for(Index k=0; k<sched.size(); ++k)
+		{
+			const Index j = sched[k];
+
+			if(j < np)
+			{
+				claimParticle(j, gt[0]);
+				move(j, gt[0]);
+				cst(j) = f(pos[j]); /* cost of the pending update */
+			}
+			else
+			{
+				update(j - np, cst(j - np));
+			}
+		}
+	}
+
+	// Claims the next particle not being evaluated; returns false on termination
+	bool claimNext(Index& j, VectorType& g)
+	{
+		ScopedLock lock(mutex);
+
+		if(converged() or nclaim >= max_iter*np) return false;
+
+		for(Index k=0; k<np; ++k)
+		{
+			j = (next + k)%np;
+			if(not busy(j)) break;
+		}
+
+		ASSERT( not busy(j) ); /* at least one particle per thread */
+
+		next = (j + 1)%np;
+
+		claimParticle(j, g);
+
+		return true;
+	}
+
+	// Claims particle j (caller holds the lock, or runs serially)
+	void claimParticle(Index j, VectorType& g)
+	{
+		busy(j) = true;
+		++nclaim;
+
+		r1(j) = rng.number();
+		r2(j) = rng.number();
+
+		g = gbest_pos;
+
+		if(record and not replay) sched.push_back(j);
+	}
+
+	// Moves particle j relative to the global best g
+	void move(Index j, const VectorType& g)
+	{
+		VectorType& x = pos[j];
+		VectorType& v = vel[j];
+		const VectorType& p = pbest_pos[j];
+
+		const Real a1 = c1*r1(j);
+		const Real a2 = c2*r2(j);
+
+		for(Index i=0; i<dim; ++i)
+			v(i) = w*v(i) + a1*(p(i) - x(i)) + a2*(g(i) - x(i));
+
+		constrict(v);
+
+		x += v;
+	}
+
+	// Sets the cost of particle j, and updates personal and global best
+	void update(Index j, Real fj)
+	{
+		ScopedLock lock(mutex);
+
+		cst(j) = fj;
+
+		if(fj < pbest_cst(j))
+		{
+			pbest_cst(j) = fj;
+			pbest_pos[j] = pos[j];
+		}
+
+		if(gbest_cst - fj > tol)
+			stall = 0;
+		else
+			++stall;
+
+		if(fj < gbest_cst)
+		{
+			gbest_cst = fj;
+			gbest_pos = pos[j];
+		}
+
+		++neval;
+		busy(j) = false;
+
+		if(record and not replay) sched.push_back(np + j);
+	}
+
+	// Scales velocity v to the maximum velocity
+	void constrict(VectorType& v) const
+	{
+		Real vn = 0.0;
+		for(Index i=0; i<dim; ++i)
+			vn += v(i)*v(i);
+		vn = std::sqrt(vn);
+
+		if(vn > vmax) v *= vmax/vn;
+	}
+
+};
+
+}}//::numlib::optimization
+
+#endif
@@ -0,0 +1,119 @@
+/*! \file OptimizerBKQ.h
+ *  \brief OptimizerBKQ template definition
+ */
+
+#ifndef OPTIMIZER_BKQ_H
+#define OPTIMIZER_BKQ_H
+
+#include "../base/parallel_tools.h"
+
+#include "ParallelBracketFinder.h"
+#include "KSection.h"
+#include "QuadraticInterp.h"
+
+namespace numlib{ namespace optimization{
+
+//! 1-dimensional unconstrained optimizer with concurrent cost evaluations
+/*!
+ *  Parallel counterpart of OptimizerBGQ, for expensive cost functions which
+ *  may be evaluated concurrently. The same three steps are applied:
+ *  1. Bracket method (ParallelBracketFinder): k steps per round
+ *  2. k-section search (KSection): in place of golden section search
+ *  3. Quadratic interpolation (QuadraticInterp): serial, as for OptimizerBGQ
+ *
+ *  The number of points evaluated concurrently per round, k, defaults to
+ *  the number of threads (at least 3). An odd k lets KSection reuse the
+ *  midpoint (see KSection).
+ *
+ *  The template argument CostFunction may be any callable class or
+ *  function pointer, which must be safe to call concurrently (note that
+ *  LineRestriction is not).
+ */
+template<class CostFunction>
+class OptimizerBKQ
+{
+public:
+
+	//! Initializes optimizer parameters
+	/*!
+	 *  Constructor arguments:
+	 *	- bf_step := step size used by ParallelBracketFinder
+	 *	- ks_reduction := interval reduction ratio used to terminate KSection
+	 *	- qf_tol := tolerance (max change in f) used to terminate QuadraticInterp
+	 *	- k := points per round (0 for the default; KSection uses at least 2)
+	 */
+	OptimizerBKQ(Real bf_step=1.0, Real ks_reduction=0.1, Real qf_tol=5.0E-3, Size k=0):
+		bracketFinder(bf_step, defaultPoints(k)),
+		kSection(ks_reduction, max(defaultPoints(k), Size(2))),
+		quadraticInterp(qf_tol)
+	{}
+
+	//! Sets step size used by ParallelBracketFinder
+	void bracketStepSize(Real bf_step) {bracketFinder.stepSize(bf_step);}
+
+	//! Returns step size used by ParallelBracketFinder
+	Real bracketStepSize() const {return bracketFinder.stepSize();}
+
+	//! Sets interval reduction ratio used to terminate KSection
+	void reductionRatio(Real ks_reduction) {kSection.reductionRatio(ks_reduction);}
+
+	//! Returns interval reduction ratio used to terminate KSection
+	Real reductionRatio() const {return kSection.reductionRatio();}
+
+	//! Sets tolerance used to terminate QuadraticInterp
+	void tolerance(Real qf_tol) {quadraticInterp.tolerance(qf_tol);}
+
+	//! Returns tolerance used to terminate QuadraticInterp
+	Real tolerance() const {return quadraticInterp.tolerance();}
+
+	//! Sets number of points evaluated concurrently per round
+	void points(Size k)
+	{
+		bracketFinder.points(k);
+		kSection.points(max(k, Size(2)));
+	}
+
+	//! Returns number of points evaluated concurrently per round
+	Size points() const {return kSection.points();}
+
+	//! Finds a minimum of the cost function 'f'
+	ErrorCode minimize(CostFunction& f, Minimum1D& min)
+	{
+		ErrorCode code;
+
+		// Attempt to bracket a minimum...
+
+		code = bracketFinder.minimize(f, min);
+
+		if(code != SUCCESS) return code;
+
+		// Reduce search interval and get rough estimate for optimum...
+
+		code = kSection.minimize(f, min);
+
+		if(code != SUCCESS) return code;
+
+		// Refine optimum estimate...
+
+		code = quadraticInterp.minimize(f, min);
+
+		return code;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( OptimizerBKQ );
+
+	ParallelBracketFinder<CostFunction> bracketFinder;
+
+	KSection<CostFunction> kSection;
+
+	QuadraticInterp<CostFunction> quadraticInterp;
+
+	static Size defaultPoints(Size k) {return (k > 0) ? k : max(maxThreads(), Size(3));}
+
+};
+
+}}//::numlib::optimization
+
+#endif
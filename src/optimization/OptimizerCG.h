@@ -24,8 +24,8 @@ public:
 	typedef MinimumND<VectorType> Minimum;
 
 	OptimizerCG(Size dim, Real bf_step=1.0, Real gs_reduction=0.1, Real tol_=5.0E-3, Size max_iter_=1000):
-		n(dim), tol(tol_), max_iter(max_iter_), dir(n), grad(n),
-		line_search(bf_step, gs_reduction, tol)
+		n(dim), tol(tol_), max_iter(max_iter_), dir(n), grad(n), grad_prev(n),
+		xopt(n), line_search(bf_step, gs_reduction, tol)
 	{}
 
 	//! Sets convergence tolerance used to terminate execution of OptimizerCG::minimize
@@ -62,7 +62,7 @@ public:
 	//! Executes one iteration: refines the optimum design estimate
 	ErrorCode iter(CostFunction& f, Minimum& min)
 	{
-		VectorType xopt = min.design();
+		xopt = min.design();
 		Real fopt = min.cost();
 
 		// Set up restriction of f to 1-dimensional subspace...
@@ -79,18 +79,20 @@ public:
 
 		// Update design and cost...
 
-		xopt += line_min.design()*dir;
+		const Real alpha = line_min.design();
+		for(Index i=0; i<n; ++i)
+			xopt(i) += alpha*dir(i);
 		fopt  = line_min.cost();
 
 		min.design(xopt, fopt);
 
 		// Update search direction using Polak-Ribiere formula...
 
-		VectorType grad_prev(grad);
+		grad_prev.swap(grad);
 
 		f(xopt, grad);
 
-		Real beta = prod(grad, grad - grad_prev)/prod(grad_prev, grad_prev);
+		Real beta = (prod(grad, grad) - prod(grad, grad_prev))/prod(grad_prev, grad_prev);
 
 		dir *= beta;
 		dir -= grad;
@@ -140,7 +142,7 @@ public:
 			// Check convergence criteria...
 
 			Real delta_f = fopt - min.cost();
-			if(fabs(delta_f) < tol) return code;
+			if(std::fabs(delta_f) < tol) return code;
 		}
 
 		return EXCEEDED_MAX_ITER;
@@ -162,6 +164,12 @@ private:
 
 	VectorType grad;
 
+	//! Gradient of the previous iteration
+	VectorType grad_prev;
+
+	//! Design work space
+	VectorType xopt;
+
 	OptimizerBGQ< LineRes > line_search;
 
 };
@@ -0,0 +1,417 @@
+/*! \file OptimizerIslandPSO.h
+ *  \brief OptimizerIslandPSO class template definition
+ */
+
+#ifndef OPTIMIZER_ISLAND_PSO_H
+#define OPTIMIZER_ISLAND_PSO_H
+
+#include <cmath>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/parallel_tools.h"
+#include "../array/Array1D.h"
+#include "../array/PointerArray.h"
+
+#include "optimization_error_codes.h"
+#include "MinimumND.h"
+#include "OptimizerPSOSoA.h"
+#include "StretchingOperator.h"
+
+namespace numlib{ namespace optimization{
+
+//! Island model Particle Swarm Optimization with several independent swarms
+/*!
+ *	Runs several swarms ("islands", see OptimizerPSOSoA) side by side,
+ *	each advanced by its own thread with its own random number generator
+ *	(seeded seed + i for island i). Every migrationInterval iterations the
+ *	islands exchange particles: the best particles (see migrants) of a source
+ *	island replace the worst particles of the receiving island. With the
+ *	RING topology island i receives from island i-1; with FULLY_CONNECTED
+ *	every island receives from the best (other) island. Since the islands
+ *	only interact at migration, which is done serially, the result depends
+ *	only on the seed, not on the number of threads.
+ *
+ *	Optionally (see stretching), an island which is trapped in a local
+ *	minimum, i.e. one which did not improve its best by more than the
+ *	tolerance during a migration interval, and whose best is worse than the
+ *	global best found by another island, is restarted with its cost function
+ *	stretched about the global best (see StretchingOperator). Stretching
+ *	elevates every point whose cost exceeds that of the global best,
+ *	deflating the local minima found so far, while leaving better points
+ *	unchanged; thus, the island keeps searching for a better minimum
+ *	instead of idling. Stretched islands neither send nor receive migrants.
+ *
+ *	The convergence criterion is that of OptimizerPSO::minimize, applied to
+ *	the global best after every migration interval. The cost function must
+ *	be safe to call concurrently.
+ */
+template<class F, class V>
+class OptimizerIslandPSO
+{
+public:
+
+	typedef F FunctionType;
+	typedef V VectorType;
+	typedef MinimumND<VectorType> Minimum;
+
+	//! Migration topologies
+	enum Topology {RING, FULLY_CONNECTED};
+
+	//! Cost function of an island (stretched, or not)
+	class IslandFunction
+	{
+	public:
+
+		IslandFunction(FunctionType& f_, const VectorType& x, Real fx):
+			f(f_), stretched(false), stretching(f_, x, fx)
+		{}
+
+		Real operator()(const VectorType& x) {return stretched ? stretching(x) : f(x);}
+
+		FunctionType& f;
+
+		bool stretched;
+
+		StretchingOperator<FunctionType, VectorType> stretching;
+	};
+
+	typedef OptimizerPSOSoA<IslandFunction, VectorType> Island;
+
+	OptimizerIslandPSO(Size dim_, Size ni_, Size np_, Real tol_=5.0E-3, Size max_count_=10, Size max_iter_=1000):
+		dim(dim_), ni(ni_), np(np_), tol(tol_), max_count(max_count_), max_iter(max_iter_),
+		interval(10), nm(1), topo(RING), stretch(false), gamma_1(1.0), gamma_2(1.0), mu(1.0),
+		rseed(1), islands(ni_), funcs(ni_), mins(ni_), nrestart(ni_), restart(ni_),
+		prev_cst(ni_), emig(0), emig_cst(ni_*nm)
+	{
+		ASSERT( ni > 0 );
+
+		for(Index i=0; i<ni; ++i)
+		{
+			islands[i] = new Island(dim, np, tol, max_count, max_iter);
+			nrestart(i) = 0;
+		}
+
+		allocateMigrants();
+	}
+
+	~OptimizerIslandPSO()
+	{
+		islands.clear();
+		delete[] emig;
+	}
+
+	//! Returns the number of islands
+	Size numIslands() const {return ni;}
+
+	//! Returns island i
+	const Island& island(Index i) const {return *islands[i];}
+
+	//! Returns the number of (stretched) restarts of island i during the last run
+	Size restarts(Index i) const {return nrestart(i);}
+
+	//! Sets the inertia of each particle (see Particle::inertia)
+	void inertia(const Real w)
+	{
+		for(Index i=0; i<ni; ++i)
+			islands[i]->inertia(w);
+	}
+
+	//! Sets maximum velocity of each particle
+	void maxVelocity(const Real vmax)
+	{
+		for(Index i=0; i<ni; ++i)
+			islands[i]->maxVelocity(vmax);
+	}
+
+	//! Sets confidence of each particle in its own best
+	void selfTrust(const Real c1)
+	{
+		for(Index i=0; i<ni; ++i)
+			islands[i]->selfTrust(c1);
+	}
+
+	//! Sets confidence of each particle in the best of its island
+	void swarmTrust(const Real c2)
+	{
+		for(Index i=0; i<ni; ++i)
+			islands[i]->swarmTrust(c2);
+	}
+
+	//! Sets the seed of the random number generators (island i uses seed + i)
+	void seed(unsigned long rseed_) {rseed = rseed_;}
+
+	//! Returns the seed of the random number generators
+	unsigned long seed() const {return rseed;}
+
+	//! Sets the number of iterations between migrations
+	void migrationInterval(Size interval_)
+	{
+		ASSERT( interval_ > 0 );
+		interval = interval_;
+	}
+
+	//! Sets the number of particles sent by a source island at each migration
+	void migrants(Size nm_)
+	{
+		ASSERT( nm_ < np );
+		nm = nm_;
+		allocateMigrants();
+	}
+
+	//! Sets the migration topology
+	void topology(Topology topo_) {topo = topo_;}
+
+	//! Enables/disables restarting trapped islands with stretching (see class description)
+	void stretching(bool stretch_) {stretch = stretch_;}
+
+	//! Sets the tuning parameters of the stretching operator
+	void stretchingParams(const Real gamma_1_, const Real gamma_2_, const Real mu_)
+	{
+		gamma_1 = gamma_1_;
+		gamma_2 = gamma_2_;
+		mu = mu_;
+	}
+
+	//! Executes a complete optimization sequence
+	/*!
+	 *	Each island is initialized about min.design() (see
+	 *	OptimizerPSOSoA::newSequence). On return, min holds the best design
+	 *	found by any island.
+	 */
+	ErrorCode minimize(FunctionType& f, Minimum& min)
+	{
+		ASSERT( min.design().size() == dim );
+
+		const Size nt = numlib::min(maxThreads(), ni);
+
+		// Initialize islands...
+
+		for(Index i=0; i<ni; ++i)
+		{
+			funcs[i] = new IslandFunction(f, min.design(), min.cost());
+			funcs[i]->stretching.tunningParams(gamma_1, gamma_2, mu);
+			mins[i] = new Minimum(min);
+			islands[i]->seed(rseed + i);
+			nrestart(i) = 0;
+			restart(i) = true;
+		}
+
+		ErrorCode code = EXCEEDED_MAX_ITER;
+
+		Index count(0);
+		for(Index n=0; n<max_iter; n+=interval)
+		{
+			const Real fopt = min.cost();
+			const Size nk = numlib::min(interval, max_iter - n);
+
+			// Advance islands independently...
+
+			#pragma omp parallel for schedule(static,1) num_threads(int(nt))
+			for(Index i=0; i<ni; ++i)
+			{
+				if(restart(i))
+				{
+					islands[i]->newSequence(*funcs[i], *mins[i]);
+					restart(i) = false;
+				}
+
+				prev_cst(i) = mins[i]->cost();
+
+				for(Index k=0; k<nk; ++k)
+					islands[i]->iter(*funcs[i], *mins[i]);
+			}
+
+			updateBest(min);
+
+			// Exchange particles, and stretch trapped islands...
+
+			migrate();
+
+			if(stretch) stretchIslands(min);
+
+			// Check convergence criteria...
+
+			if(fopt - min.cost() < tol)
+				count += nk;
+			else
+				count = 0;
+
+			if(count > max_count)
+			{
+				code = SUCCESS;
+				break;
+			}
+		}
+
+		funcs.clear();
+		mins.clear();
+
+		return code;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( OptimizerIslandPSO );
+
+	//! Number of design variables
+	Size dim;
+
+	//! Number of islands
+	Size ni;
+
+	//! Number of particles per island
+	Size np;
+
+	Real tol;
+
+	Size max_count;
+
+	Size max_iter;
+
+	//! Migration interval
+	Size interval;
+
+	//! Number of migrants per source island
+	Size nm;
+
+	//! Migration topology
+	Topology topo;
+
+	//! Stretching flag and parameters
+	bool stretch;
+	Real gamma_1, gamma_2, mu;
+
+	//! Seed of the random number generators
+	unsigned long rseed;
+
+	//! Islands, their cost functions, and their best designs
+	array::PointerArray<Island> islands;
+	array::PointerArray<IslandFunction> funcs;
+	array::PointerArray<Minimum> mins;
+
+	//! Number of restarts of each island
+	array::Array1D<Size> nrestart;
+
+	//! Flags islands to be (re)initialized
+	array::Array1D<bool> restart;
+
+	//! Best cost of each island at the start of the migration interval
+	array::Array1D<Real> prev_cst;
+
+	//! Emigrants of each island (nm per island) and their costs
+	VectorType* emig;
+	array::Array1D<Real> emig_cst;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	void allocateMigrants()
+	{
+		delete[] emig;
+		emig = new VectorType[ni*nm];
+		for(Index k=0; k<ni*nm; ++k)
+			emig[k].resize(dim);
+		emig_cst.resize(ni*nm);
+	}
+
+	// Updates min with the best design of the islands
+	void updateBest(Minimum& min)
+	{
+		for(Index i=0; i<ni; ++i)
+			if(mins[i]->cost() < min.cost())
+				min.design(mins[i]->design(), mins[i]->cost());
+	}
+
+	// Sends the best nm particles of each (unstretched) island to its neighbor
+	void migrate()
+	{
+		if(ni < 2 or nm == 0) return;
+
+		// Collect emigrants (before any island is changed)...
+
+		for(Index i=0; i<ni; ++i)
+			if(not funcs[i]->stretched)
+				emigrants(i);
+
+		// Receive immigrants...
+
+		for(Index i=0; i<ni; ++i)
+		{
+			if(funcs[i]->stretched) continue;
+
+			Index s = (i + ni - 1)%ni;
+
+			if(topo == FULLY_CONNECTED)
+			{
+				s = i;
+				for(Index j=0; j<ni; ++j)
+					if( (j != i) and (not funcs[j]->stretched) and
+						( (s == i) or (mins[j]->cost() < mins[s]->cost()) ) )
+						s = j;
+			}
+
+			if( (s == i) or funcs[s]->stretched ) continue;
+
+			for(Index k=0; k<nm; ++k)
+				islands[i]->immigrate(emig[s*nm+k], emig_cst(s*nm+k), *mins[i]);
+		}
+	}
+
+	// Copies the best nm personal bests of island i to its emigrants
+	void emigrants(Index i)
+	{
+		const Island& isl = *islands[i];
+		const linalg::Matrix<Real>& pbest = isl.bestPositionMatrix();
+
+		// Select in order of increasing (cost, index)...
+
+		Index last = 0;
+		for(Index k=0; k<nm; ++k)
+		{
+			Index b = np;
+			for(Index j=0; j<np; ++j)
+			{
+				if( (k > 0) and not after(isl, j, last) ) continue;
+
+				if( (b == np) or after(isl, b, j) )
+					b = j;
+			}
+
+			for(Index d=0; d<dim; ++d)
+				emig[i*nm+k](d) = pbest(d,b);
+			emig_cst(i*nm+k) = isl.bestCost(b);
+			last = b;
+		}
+	}
+
+	// Returns true if particle j follows particle l in order of (cost, index)
+	static bool after(const Island& isl, Index j, Index l)
+	{
+		return (isl.bestCost(j) > isl.bestCost(l)) or
+			( (isl.bestCost(j) == isl.bestCost(l)) and (j > l) );
+	}
+
+	// Flags trapped islands for a restart with the cost stretched about min
+	void stretchIslands(const Minimum& min)
+	{
+		for(Index i=0; i<ni; ++i)
+		{
+			const bool improved = prev_cst(i) - mins[i]->cost() > tol;
+			const bool trailing = mins[i]->cost() > min.cost();
+
+			if(improved or not trailing) continue;
+
+			funcs[i]->stretched = true;
+			funcs[i]->stretching.localMinimum(min.design(), min.cost());
+
+			islands[i]->seed(rseed + i + ni*(++nrestart(i)));
+			restart(i) = true;
+		}
+	}
+
+};
+
+}}//::numlib::optimization
+
+#endif
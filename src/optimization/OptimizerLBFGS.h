@@ -0,0 +1,426 @@
+/*! \file OptimizerLBFGS.h
+ *  \brief OptimizerLBFGS template definition
+ */
+
+#ifndef OPTIMIZER_LBFGS_H
+#define OPTIMIZER_LBFGS_H
+
+#include <cmath>
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/nocopy.h"
+#include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
+#include "optimization_error_codes.h"
+#include "MinimumND.h"
+
+namespace numlib{ namespace optimization{
+
+//! Multi-variate optimizer based on the limited memory BFGS algorithm
+/*!
+ *  The search direction is d = -H*g, where H is the BFGS approximation of
+ *  the inverse Hessian defined by the last m curvature pairs,
+ *
+ *     s_k = x_{k+1} - x_k,  y_k = g_{k+1} - g_k
+ *
+ *  and evaluated by the two-loop recursion (Nocedal, J., and S.J. Wright.
+ *  "Numerical Optimization." 2nd ed., Springer, 2006; Algorithm 7.4), with
+ *  the initial inverse Hessian scaled by s*y/y*y of the newest pair. The
+ *  pairs are stored in a circular buffer; pairs which do not satisfy the
+ *  curvature condition, s*y > 0, are skipped.
+ *
+ *  The step length satisfies the strong Wolfe conditions (Algorithms 3.5
+ *  and 3.6 of the same reference, with safeguarded cubic interpolation);
+ *  each trial step evaluates both the cost and the gradient, and the
+ *  gradient of the accepted step is reused as the gradient of the next
+ *  iteration. The unit step is tried first (the first iteration tries a
+ *  step of unit length instead).
+ *
+ *  The cost function implements the interface of CostFunctionND; i.e.
+ *  f(x) returns the cost, and f(x, grad) computes the gradient. All work
+ *  vectors are allocated at construction; iterations do not allocate.
+ */
+template<class CostFunction>
+class OptimizerLBFGS
+{
+public:
+
+	typedef typename CostFunction::VectorType VectorType;
+
+	typedef MinimumND<VectorType> Minimum;
+
+	//! Initializes optimizer
+	/*!
+	 *  Arguments:
+	 *    dim: number of design variables
+	 *    m_: number of curvature pairs retained (memory)
+	 *    tol_: gradient norm used to terminate OptimizerLBFGS::minimize
+	 *    max_iter_: maximum number of iterations
+	 */
+	OptimizerLBFGS(Size dim, Size m_=5, Real tol_=1.0E-6, Size max_iter_=1000):
+		n(dim), m(m_), tol(tol_), max_iter(max_iter_), c1(1.0E-4), c2(0.9),
+		max_eval(20), nhist(0), head(0), nevals(0), s(0), y(0), rho(m_),
+		alpha(m_), x(dim), grad(dim), dir(dim), xt(dim), gt(dim)
+	{
+		ASSERT( m > 0 );
+
+		s = new VectorType[m];
+		y = new VectorType[m];
+		for(Index i=0; i<m; ++i)
+		{
+			s[i].resize(n);
+			y[i].resize(n);
+		}
+	}
+
+	~OptimizerLBFGS()
+	{
+		delete[] s;
+		delete[] y;
+	}
+
+	//! Sets convergence tolerance (gradient norm) used to terminate OptimizerLBFGS::minimize
+	void tolerance(Real tol_) {tol = tol_;}
+
+	//! Returns tolerance used to terminate OptimizerLBFGS::minimize
+	Real tolerance() const {return tol;}
+
+	//! Sets maximum allowable iterations executed by OptimizerLBFGS::minimize
+	void maxIteration(Size max_iter_) {max_iter = max_iter_;}
+
+	//! Returns maximum allowable iterations executed by OptimizerLBFGS::minimize
+	Size maxIteration() const {return max_iter;}
+
+	//! Sets sufficient decrease (c1) and curvature (c2) parameters, 0 < c1 < c2 < 1
+	void wolfeParameters(Real c1_, Real c2_)
+	{
+		ASSERT( (0 < c1_) and (c1_ < c2_) and (c2_ < 1) );
+		c1 = c1_;
+		c2 = c2_;
+	}
+
+	//! Sets maximum number of function evaluations per line search
+	void maxLineEvaluations(Size max_eval_) {max_eval = max_eval_;}
+
+	//! Returns the number of curvature pairs retained (memory)
+	Size memory() const {return m;}
+
+	//! Returns the number of curvature pairs currently stored
+	Size historySize() const {return nhist;}
+
+	//! Returns the number of function (and gradient) evaluations of the last line search
+	Size lineEvaluations() const {return nevals;}
+
+	//! Returns search direction used during the last call to iter
+	const VectorType& searchDirection() const {return dir;}
+
+	//! Returns norm of the gradient at the current design
+	Real gradientNorm() const {return norm2(grad);}
+
+	//! Resets optimizer to begin a new iteration sequence
+	/*!
+	 *  The cost of the initial design, min.design(), is evaluated and
+	 *  stored in min.
+	 */
+	ErrorCode newSequence(CostFunction& f, Minimum& min)
+	{
+		ASSERT( min.size() == n );
+
+		x = min.design();
+		min.design(x, f(x));
+		f(x, grad);
+		nhist = 0;
+		head = 0;
+
+		return SUCCESS;
+	}
+
+	//! Executes one iteration: refines the optimum design estimate
+	ErrorCode iter(CostFunction& f, Minimum& min)
+	{
+		const Real f0 = min.cost();
+
+		// Compute search direction...
+
+		twoLoop();
+
+		Real dphi0 = prod(grad, dir);
+
+		if(not (dphi0 < 0))
+		{
+			// Not a descent direction; restart with steepest descent...
+			nhist = 0;
+			dir  = grad;
+			dir *= -1.0;
+			dphi0 = -prod(grad, grad);
+			if(not (dphi0 < 0)) return SUCCESS;
+		}
+
+		// Execute line search...
+
+		const Real a0 = (nhist > 0) ? 1.0 : 1.0/norm2(dir);
+		Real ft;
+
+		ErrorCode code = lineSearch(f, f0, dphi0, a0, ft);
+
+		if(code!=SUCCESS) return code;
+
+		// Store curvature pair, s = xt - x, y = gt - g...
+
+		VectorType & sk = s[head];
+		VectorType & yk = y[head];
+
+		Real sy = 0.0;
+		for(Index i=0; i<n; ++i)
+		{
+			sk(i) = xt(i) - x(i);
+			yk(i) = gt(i) - grad(i);
+			sy += sk(i)*yk(i);
+		}
+
+		if(sy > 0)
+		{
+			rho(head) = 1.0/sy;
+			head = (head + 1) % m;
+			nhist = numlib::min(nhist + 1, m);
+		}
+
+		// Update design and gradient...
+
+		x.swap(xt);
+		grad.swap(gt);
+
+		min.design(x, ft);
+
+		return SUCCESS;
+	}
+
+	//! Executes a complete optimization sequence until convergence or failure
+	/*!
+	 *  This is essentially a wrapper around OptimizerLBFGS::newSequence and
+	 *  OptimizerLBFGS::iter, which terminates when the gradient norm is less
+	 *  than the tolerance.
+	 */
+	ErrorCode minimize(CostFunction& f, Minimum& min)
+	{
+		ErrorCode code = newSequence(f, min);
+
+		if(code!=SUCCESS) return code;
+
+		for(Index k=0; k<max_iter; ++k)
+		{
+			if(norm2(grad) < tol) return SUCCESS;
+
+			code = iter(f, min);
+			if(code!=SUCCESS) return code;
+		}
+
+		return (norm2(grad) < tol) ? SUCCESS : EXCEEDED_MAX_ITER;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( OptimizerLBFGS );
+
+	Size n;
+
+	//! Memory (maximum number of curvature pairs)
+	Size m;
+
+	Real tol;
+
+	Size max_iter;
+
+	//! Wolfe condition parameters
+	Real c1, c2;
+
+	//! Maximum number of evaluations per line search
+	Size max_eval;
+
+	//! Number of stored pairs, and slot of the next pair
+	Size nhist, head;
+
+	//! Number of evaluations of the last line search
+	Size nevals;
+
+	//! Curvature pairs (circular buffers)
+	VectorType* s;
+	VectorType* y;
+
+	//! 1/(s*y) of each pair
+	linalg::Vector<Real> rho;
+
+	//! Two-loop recursion coefficients
+	linalg::Vector<Real> alpha;
+
+	//! Current design, gradient, and search direction
+	VectorType x, grad, dir;
+
+	//! Trial design and gradient
+	VectorType xt, gt;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Returns slot of the j-th newest pair (j = 0 is the newest)
+	Index slot(Index j) const
+	{
+		return (head + m - 1 - j) % m;
+	}
+
+	// Sets dir = -H*grad by the two-loop recursion
+	void twoLoop()
+	{
+		dir = grad;
+
+		for(Index j=0; j<nhist; ++j)
+		{
+			const Index k = slot(j);
+			alpha(k) = rho(k)*prod(s[k], dir);
+			for(Index i=0; i<n; ++i)
+				dir(i) -= alpha(k)*y[k](i);
+		}
+
+		if(nhist > 0)
+		{
+			const Index k = slot(0);
+			dir *= 1.0/(rho(k)*prod(y[k], y[k]));
+		}
+
+		for(Index j=nhist; j-- > 0; )
+		{
+			const Index k = slot(j);
+			const Real beta = rho(k)*prod(y[k], dir);
+			for(Index i=0; i<n; ++i)
+				dir(i) += (alpha(k) - beta)*s[k](i);
+		}
+
+		dir *= -1.0;
+	}
+
+	// Evaluates phi(a) = f(x + a*dir) and phi'(a); the point is kept in xt, gt
+	Real phi(CostFunction& f, Real a, Real& dphi)
+	{
+		for(Index i=0; i<n; ++i)
+			xt(i) = x(i) + a*dir(i);
+
+		const Real fa = f(xt);
+		f(xt, gt);
+		dphi = prod(gt, dir);
+		++nevals;
+
+		return fa;
+	}
+
+	// Finds a step satisfying the strong Wolfe conditions; on success, the
+	// accepted point and its gradient are held in xt and gt
+	ErrorCode lineSearch(CostFunction& f, Real f0, Real dphi0, Real a1, Real& fa)
+	{
+		nevals = 0;
+
+		Real a_prev = 0.0;
+		Real f_prev = f0;
+		Real d_prev = dphi0;
+		Real a = a1;
+
+		while(nevals < max_eval)
+		{
+			Real da;
+			fa = phi(f, a, da);
+
+			if( (fa > f0 + c1*a*dphi0) or ( (nevals > 1) and (fa >= f_prev) ) )
+				return zoom(f, f0, dphi0, a_prev, f_prev, d_prev, a, fa, da, fa);
+
+			if(std::fabs(da) <= -c2*dphi0)
+				return SUCCESS;
+
+			if(da >= 0)
+				return zoom(f, f0, dphi0, a, fa, da, a_prev, f_prev, d_prev, fa);
+
+			a_prev = a;
+			f_prev = fa;
+			d_prev = da;
+			a *= 2.0;
+		}
+
+		return NO_MIN;
+	}
+
+	// Refines the bracketing interval [alo, ahi] (see Nocedal and Wright)
+	ErrorCode zoom(CostFunction& f, Real f0, Real dphi0,
+		Real alo, Real flo, Real dlo, Real ahi, Real fhi, Real dhi, Real& fa)
+	{
+		while(nevals < max_eval)
+		{
+			const Real a = interpolate(alo, flo, dlo, ahi, fhi, dhi);
+
+			Real da;
+			fa = phi(f, a, da);
+
+			if( (fa > f0 + c1*a*dphi0) or (fa >= flo) )
+			{
+				ahi = a;
+				fhi = fa;
+				dhi = da;
+			}
+			else
+			{
+				if(std::fabs(da) <= -c2*dphi0)
+					return SUCCESS;
+
+				if(da*(ahi - alo) >= 0)
+				{
+					ahi = alo;
+					fhi = flo;
+					dhi = dlo;
+				}
+
+				alo = a;
+				flo = fa;
+				dlo = da;
+			}
+		}
+
+		// Accept the best point found if it sufficiently decreases f...
+
+		if(flo < f0)
+		{
+			Real da;
+			fa = phi(f, alo, da);
+			return SUCCESS;
+		}
+
+		return NO_MIN;
+	}
+
+	// Minimizer of the cubic interpolating phi and phi' at a0 and a1,
+	// safeguarded to the interior of the interval
+	static Real interpolate(Real a0, Real f0, Real d0, Real a1, Real f1, Real d1)
+	{
+		const Real lo = numlib::min(a0, a1);
+		const Real hi = numlib::max(a0, a1);
+		const Real w = 0.1*(hi - lo);
+
+		const Real e1 = d0 + d1 - 3.0*(f0 - f1)/(a0 - a1);
+		const Real disc = e1*e1 - d0*d1;
+
+		Real a = 0.5*(lo + hi);
+		if(disc >= 0)
+		{
+			const Real e2 = ( (a1 > a0) ? 1.0 : -1.0 )*std::sqrt(disc);
+			const Real den = d1 - d0 + 2.0*e2;
+			if(den != 0)
+				a = a1 - (a1 - a0)*(d1 + e2 - e1)/den;
+		}
+
+		if( not ( (a >= lo + w) and (a <= hi - w) ) )
+			a = 0.5*(lo + hi);
+
+		return a;
+	}
+
+};
+
+}}//::numlib::optimization
+
+#endif
@@ -0,0 +1,515 @@
+/*! \file OptimizerMultiStart.h
+ *  \brief OptimizerMultiStart class template definition
+ */
+
+#ifndef OPTIMIZER_MULTI_START_H
+#define OPTIMIZER_MULTI_START_H
+
+#include <cmath>
+#include <vector>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/parallel_tools.h"
+#include "../array/Array1D.h"
+#include "../array/PointerArray.h"
+#include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
+
+#include "optimization_error_codes.h"
+#include "MinimumND.h"
+#include "OptimizerLBFGS.h"
+#include "StretchingOperator.h"
+
+namespace numlib{ namespace optimization{
+
+//! Global optimizer based on concurrent local searches from many starting points
+/*!
+ *	Launches a local search (by default OptimizerLBFGS; OptimizerCG may be
+ *	used as well) from each of a number of starting points, which are the
+ *	points of the Halton sequence (a quasi-random sequence, which covers the
+ *	box more evenly than random points) scaled to the box [lower, upper]
+ *	(see bounds). The starts are distributed over the available threads;
+ *	each thread owns its local optimizer.
+ *
+ *	The local minima found so far are shared by all threads (guarded by a
+ *	Mutex). A known minimum is deemed to own the ball of radius basinRadius
+ *	about it; a start which lies within a known basin is skipped, and a
+ *	local search which enters a known basin is abandoned, and counted as a
+ *	hit of that minimum; thus, no work is duplicated converging to the same
+ *	minimum. Optionally (see stretching), the cost function of later starts
+ *	is stretched about the best minimum known when the start is launched
+ *	(see StretchingOperator), which elevates every point whose cost exceeds
+ *	that of the best minimum, so the local search is steered towards a
+ *	better minimum. The result of a stretched search is then polished by a
+ *	local search of f itself (since a minimum of the stretched function
+ *	need not be a minimum of f), and is only recorded if its cost is below
+ *	that of the best known minimum; otherwise, it is discarded. Stretching
+ *	requires the gradient of the stretched function, which is singular at
+ *	the best minimum; OptimizerLBFGS, whose line search is bounded, is
+ *	recommended, since the quadratic interpolation of OptimizerCG may fail
+ *	to terminate on it.
+ *
+ *	Each local search iterates until the cost changes by less than the
+ *	tolerance, or the maximum number of iterations is reached; searches
+ *	which fail (e.g. the line search finds no minimum) are discarded. Since
+ *	the starts share the set of minima, which minima are found (and which
+ *	starts are skipped) may depend on the number of threads and the timing
+ *	of the threads; the result is repeatable with a single thread.
+ *
+ *	The template argument F implements the interface of CostFunctionND, and
+ *	must be safe to call concurrently; the local optimizer must be
+ *	constructible from the number of design variables alone.
+ */
+template<class F, template<class> class LocalOptimizer=OptimizerLBFGS>
+class OptimizerMultiStart
+{
+public:
+
+	typedef F FunctionType;
+	typedef typename F::VectorType VectorType;
+	typedef MinimumND<VectorType> Minimum;
+
+	//! Cost function of a local search (stretched, or not)
+	class StartFunction
+	{
+	public:
+
+		typedef typename F::VectorType VectorType;
+
+		StartFunction(FunctionType& f_, const VectorType& x, Real fx):
+			f(f_), stretched(false), stretching(f_, x, fx)
+		{}
+
+		Real operator()(const VectorType& x) {return stretched ? stretching(x) : f(x);}
+
+		void operator()(const VectorType& x, VectorType& grad)
+		{
+			if(stretched)
+				stretching(x, grad);
+			else
+				f(x, grad);
+		}
+
+		FunctionType& f;
+
+		bool stretched;
+
+		StretchingOperator<FunctionType, VectorType> stretching;
+	};
+
+	typedef LocalOptimizer<StartFunction> Local;
+
+	//! Initializes optimizer
+	/*!
+	 *  Arguments:
+	 *    dim_: number of design variables
+	 *    nstart_: number of starting points
+	 *    tol_: change in cost used to terminate each local search
+	 *    max_iter_: maximum number of iterations of each local search
+	 */
+	OptimizerMultiStart(Size dim_, Size nstart_=100, Real tol_=1.0E-6, Size max_iter_=1000):
+		dim(dim_), nstart(nstart_), tol(tol_), max_iter(max_iter_), radius(0.1),
+		stretch(false), gamma_1(1.0), gamma_2(1.0), mu(1.0), lower(dim_), upper(dim_),
+		primes(dim_), nskip(0), nabandon(0), nfail(0), ndiscard(0)
+	{
+		for(Index i=0; i<dim; ++i)
+		{
+			lower(i) = 0.0;
+			upper(i) = 1.0;
+		}
+
+		// Halton sequence bases (the first dim primes)...
+
+		Index p = 2;
+		for(Index i=0; i<dim; ++i, ++p)
+		{
+			while(not isPrime(p)) ++p;
+			primes(i) = p;
+		}
+	}
+
+	//! Sets the box of starting points (the unit cube by default)
+	void bounds(const VectorType& lower_, const VectorType& upper_)
+	{
+		ASSERT( lower_.size() == dim );
+		ASSERT( upper_.size() == dim );
+		lower = lower_;
+		upper = upper_;
+	}
+
+	//! Sets number of starting points
+	void starts(Size nstart_) {nstart = nstart_;}
+
+	//! Returns number of starting points
+	Size starts() const {return nstart;}
+
+	//! Sets change in cost used to terminate each local search
+	void tolerance(Real tol_) {tol = tol_;}
+
+	//! Returns change in cost used to terminate each local search
+	Real tolerance() const {return tol;}
+
+	//! Sets maximum number of iterations of each local search
+	void maxIteration(Size max_iter_) {max_iter = max_iter_;}
+
+	//! Returns maximum number of iterations of each local search
+	Size maxIteration() const {return max_iter;}
+
+	//! Sets radius of the basin owned by a known minimum
+	void basinRadius(Real radius_) {radius = radius_;}
+
+	//! Returns radius of the basin owned by a known minimum
+	Real basinRadius() const {return radius;}
+
+	//! Enables (or disables) stretching about the best known minimum
+	void stretching(bool stretch_) {stretch = stretch_;}
+
+	//! Returns true if stretching is enabled
+	bool stretching() const {return stretch;}
+
+	//! Sets stretching tuning parameters (see StretchingOperator)
+	void stretchingParams(const Real gamma_1_, const Real gamma_2_, const Real mu_)
+	{
+		gamma_1 = gamma_1_;
+		gamma_2 = gamma_2_;
+		mu = mu_;
+	}
+
+	//! Returns the number of local minima found during the last run
+	Size minima() const {return xmin.size();}
+
+	//! Returns local minimum k
+	const VectorType& minimum(Index k) const {return xmin[k];}
+
+	//! Returns the cost at local minimum k
+	Real minimumCost(Index k) const {return fmin[k];}
+
+	//! Returns the number of local searches which converged to (or entered the basin of) minimum k
+	Size hits(Index k) const {return nhit[k];}
+
+	//! Returns the number of starts skipped during the last run
+	Size skipped() const {return nskip;}
+
+	//! Returns the number of local searches abandoned during the last run
+	Size abandoned() const {return nabandon;}
+
+	//! Returns the number of failed local searches during the last run
+	Size failures() const {return nfail;}
+
+	//! Returns the number of stretched search results discarded (not better than the best minimum) during the last run
+	Size discarded() const {return ndiscard;}
+
+	//! Returns the i-th coordinate of starting point k (k = 0, 1, ...)
+	Real startingPoint(Index k, Index i) const
+	{
+		return lower(i) + (upper(i) - lower(i))*radicalInverse(k + 1, primes(i));
+	}
+
+	//! Searches for the global minimum
+	/*!
+	 *	Upon input, min must hold a design of the right size (its cost is
+	 *	not used). Upon output, min holds the best minimum found, and SUCCESS
+	 *	is returned; NO_MIN is returned if every local search failed. The
+	 *	minima found are available from minimum and minimumCost.
+	 */
+	ErrorCode minimize(FunctionType& f, Minimum& min)
+	{
+		ASSERT( min.design().size() == dim );
+
+		const Size nt = maxThreads();
+
+		xmin.clear();
+		fmin.clear();
+		nhit.clear();
+		nskip = 0;
+		nabandon = 0;
+		nfail = 0;
+		ndiscard = 0;
+
+		// Initialize per-thread cost functions and local optimizers...
+
+		funcs.resize(nt);
+		locals.resize(nt);
+		for(Index t=0; t<nt; ++t)
+		{
+			funcs[t] = new StartFunction(f, min.design(), min.cost());
+			funcs[t]->stretching.tunningParams(gamma_1, gamma_2, mu);
+			locals[t] = new Local(dim);
+		}
+
+		// Launch local searches...
+
+		#pragma omp parallel for schedule(dynamic)
+		for(int k=0; k<int(nstart); ++k)
+		{
+			const Index t = threadIndex();
+			search(Index(k), *funcs[t], *locals[t]);
+		}
+
+		funcs.clear();
+		locals.clear();
+
+		if(xmin.empty()) return NO_MIN;
+
+		Index kbest = 0;
+		for(Index k=1; k<xmin.size(); ++k)
+			if(fmin[k] < fmin[kbest])
+				kbest = k;
+
+		min.design(xmin[kbest], fmin[kbest]);
+
+		return SUCCESS;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( OptimizerMultiStart );
+
+	//! Number of design variables
+	Size dim;
+
+	//! Number of starting points
+	Size nstart;
+
+	//! Local search termination parameters
+	Real tol;
+	Size max_iter;
+
+	//! Basin radius
+	Real radius;
+
+	//! Stretching flag and parameters
+	bool stretch;
+	Real gamma_1, gamma_2, mu;
+
+	//! Box of starting points
+	VectorType lower, upper;
+
+	//! Halton sequence bases
+	array::Array1D<Index> primes;
+
+	//! Per-thread cost functions and local optimizers
+	array::PointerArray<StartFunction> funcs;
+	array::PointerArray<Local> locals;
+
+	//! Known minima, their costs, and hit counts
+	std::vector<VectorType> xmin;
+	std::vector<Real> fmin;
+	std::vector<Size> nhit;
+
+	//! Statistics
+	Size nskip, nabandon, nfail, ndiscard;
+
+	//! Guards the known minima and statistics
+	Mutex mutex;
+
+	//! Outcomes of a local search
+	enum SearchResult {CONVERGED, ABANDONED, FAILED};
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Executes the local search from starting point k
+	void search(Index k, StartFunction& g, Local& local)
+	{
+		VectorType x(dim);
+		for(Index i=0; i<dim; ++i)
+			x(i) = startingPoint(k, i);
+
+		Real fstretch = 0.0;
+
+		// Skip start if in a known basin, otherwise set up cost function...
+
+		{
+			ScopedLock lock(mutex);
+
+			if(claimBasin(x))
+			{
+				++nskip;
+				return;
+			}
+
+			g.stretched = false;
+			if(stretch and not fmin.empty())
+			{
+				Index kbest = 0;
+				for(Index j=1; j<fmin.size(); ++j)
+					if(fmin[j] < fmin[kbest])
+						kbest = j;
+
+				g.stretched = true;
+				g.stretching.localMinimum(xmin[kbest], fmin[kbest]);
+				fstretch = fmin[kbest];
+			}
+		}
+
+		// Iterate until converged, or in a known basin...
+
+		Minimum m(x, g(x));
+
+		SearchResult res = iterate(g, local, m);
+
+		if(res == FAILED) countFailure();
+
+		if(res != CONVERGED) return;
+
+		// Polish result of stretched search on the cost function itself...
+		// -- Below the cost of the stretching minimum, the stretched function
+		//    is f; thus, if the polish fails (e.g. the result is already a
+		//    minimum of f), such a result is retained as is.
+
+		const bool stretched = g.stretched;
+
+		if(stretched)
+		{
+			g.stretched = false;
+
+			{
+				ScopedLock lock(mutex);
+
+				if(claimBasin(m.design()))
+				{
+					++nabandon;
+					return;
+				}
+			}
+
+			m.design(m.design(), g(m.design()));
+
+			const Minimum ms(m);
+
+			res = iterate(g, local, m);
+
+			if(res == ABANDONED) return;
+
+			if(res == FAILED)
+			{
+				if(not (ms.cost() < fstretch))
+				{
+					countFailure();
+					return;
+				}
+				m = ms;
+			}
+		}
+
+		// Record minimum (merged with a known minimum in the same basin)...
+
+		ScopedLock lock(mutex);
+
+		for(Index j=0; j<xmin.size(); ++j)
+		{
+			if(distance(m.design(), xmin[j]) < radius)
+			{
+				++nhit[j];
+				if(m.cost() < fmin[j])
+				{
+					xmin[j] = m.design();
+					fmin[j] = m.cost();
+				}
+				return;
+			}
+		}
+
+		// Discard result of stretched search unless better than the best minimum...
+
+		if(stretched)
+		{
+			Real fbest = fmin[0];
+			for(Index j=1; j<fmin.size(); ++j)
+				fbest = numlib::min(fbest, fmin[j]);
+
+			if(not (m.cost() < fbest))
+			{
+				++ndiscard;
+				return;
+			}
+		}
+
+		xmin.push_back(m.design());
+		fmin.push_back(m.cost());
+		nhit.push_back(1);
+	}
+
+	// Iterates the local search from m until converged, or in a known basin
+	SearchResult iterate(StartFunction& g, Local& local, Minimum& m)
+	{
+		ErrorCode code = local.newSequence(g, m);
+
+		for(Index n=0; (n<max_iter) and (code==SUCCESS); ++n)
+		{
+			const Real fprev = m.cost();
+
+			code = local.iter(g, m);
+			if(code!=SUCCESS) break;
+
+			if(std::fabs(fprev - m.cost()) < tol) return CONVERGED;
+
+			ScopedLock lock(mutex);
+
+			if(claimBasin(m.design()))
+			{
+				++nabandon;
+				return ABANDONED;
+			}
+		}
+
+		return FAILED;
+	}
+
+	void countFailure()
+	{
+		ScopedLock lock(mutex);
+		++nfail;
+	}
+
+	// Counts a hit, and returns true, if x lies in the basin of a known minimum
+	bool claimBasin(const VectorType& x)
+	{
+		for(Index j=0; j<xmin.size(); ++j)
+		{
+			if(distance(x, xmin[j]) < radius)
+			{
+				++nhit[j];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Returns the Euclidean distance between x and y
+	Real distance(const VectorType& x, const VectorType& y) const
+	{
+		Real d2 = 0.0;
+		for(Index i=0; i<dim; ++i)
+			d2 += (x(i) - y(i))*(x(i) - y(i));
+		return std::sqrt(d2);
+	}
+
+	// Returns the k-th element of the van der Corput sequence in base b
+	static Real radicalInverse(Index k, Index b)
+	{
+		Real h = 0.0;
+		Real s = 1.0/b;
+		while(k > 0)
+		{
+			h += s*(k % b);
+			k /= b;
+			s /= b;
+		}
+		return h;
+	}
+
+	static bool isPrime(Index p)
+	{
+		for(Index d=2; d*d<=p; ++d)
+			if(p % d == 0) return false;
+		return true;
+	}
+
+};
+
+}}//::numlib::optimization
+
+#endif
@@ -0,0 +1,413 @@
+/*! \file OptimizerNM.h
+ *  \brief OptimizerNM class template definition
+ */
+
+#ifndef OPTIMIZER_NM_H
+#define OPTIMIZER_NM_H
+
+#include <cmath>
+#include <vector>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/parallel_tools.h"
+#include "../array/Array1D.h"
+#include "../linalg/Matrix.h"
+
+#include "optimization_error_codes.h"
+#include "MinimumND.h"
+
+namespace numlib{ namespace optimization{
+
+//! Derivative free multi-variate optimizer based on the Nelder-Mead simplex method
+/*!
+ *	Maintains a simplex of dim+1 vertices. Each iteration replaces the worst
+ *	vertex, x_h, by a point on the line through x_h and the centroid, c, of
+ *	the other vertices: the reflection c + rho*(c - x_h), the expansion
+ *	c + rho*chi*(c - x_h), or the outside or inside contraction,
+ *	c + gamma*rho*(c - x_h) or c - gamma*(c - x_h); if none is acceptable,
+ *	the simplex shrinks towards the best vertex by sigma (Lagarias, J.C.,
+ *	J.A. Reeds, M.H. Wright, and P.E. Wright. "Convergence Properties of the
+ *	Nelder-Mead Simplex Method in Low Dimensions." SIAM J. Optim. Vol. 9,
+ *	pp. 112-147, 1998). The standard coefficients are rho = 1, chi = 2,
+ *	gamma = 1/2, and sigma = 1/2.
+ *
+ *	Serially, the candidates are evaluated as needed (usually one or two
+ *	per iteration). With parallelEvaluation, all four candidates are
+ *	evaluated speculatively, and concurrently, before the choice is made,
+ *	as are the vertices of a shrunk simplex; i.e. each iteration costs one
+ *	round of concurrent evaluations (two when the simplex shrinks) instead
+ *	of up to three sequential ones. The choices, and thus the result, are
+ *	the same in either mode.
+ *
+ *	The vertices are stored contiguously, one column of a dim x (dim+1)
+ *	matrix per vertex, and copied to work vectors of type V for evaluation.
+ *	The method is suited to low or moderate dimensions (say dim < 20), and
+ *	to cost functions which are not smooth, or whose gradient is not
+ *	available.
+ */
+template<class F, class V>
+class OptimizerNM
+{
+public:
+
+	typedef F FunctionType;
+	typedef V VectorType;
+	typedef MinimumND<VectorType> Minimum;
+
+	//! Initializes optimizer
+	/*!
+	 *  Arguments:
+	 *    dim_: number of design variables
+	 *    tol_: spread of the vertex costs used to terminate OptimizerNM::minimize
+	 *    max_iter_: maximum number of iterations
+	 */
+	OptimizerNM(Size dim_, Real tol_=1.0E-6, Size max_iter_=1000):
+		dim(dim_), tol(tol_), tol_x(1.0E-6), max_iter(max_iter_), step(0.1),
+		rho(1.0), chi(2.0), gamma(0.5), sigma(0.5), par(false), nevals(0),
+		xs(dim_, dim_+1), fs(dim_+1), xbar(dim_), fc(4), evaluated(4),
+		xc(4, VectorType(dim_)), xt(maxThreads(), VectorType(dim_)), ilo(0)
+	{}
+
+	//! Sets spread of the vertex costs used to terminate OptimizerNM::minimize
+	void tolerance(Real tol_) {tol = tol_;}
+
+	//! Returns spread of the vertex costs used to terminate OptimizerNM::minimize
+	Real tolerance() const {return tol;}
+
+	//! Sets simplex size (max distance of a vertex from the best, per coordinate) used to terminate OptimizerNM::minimize
+	void sizeTolerance(Real tol_x_) {tol_x = tol_x_;}
+
+	//! Returns simplex size used to terminate OptimizerNM::minimize
+	Real sizeTolerance() const {return tol_x;}
+
+	//! Sets maximum allowable iterations executed by OptimizerNM::minimize
+	void maxIteration(Size max_iter_) {max_iter = max_iter_;}
+
+	//! Returns maximum allowable iterations executed by OptimizerNM::minimize
+	Size maxIteration() const {return max_iter;}
+
+	//! Sets the edge length of the initial simplex
+	void initialStep(Real step_) {step = step_;}
+
+	//! Returns the edge length of the initial simplex
+	Real initialStep() const {return step;}
+
+	//! Sets reflection, expansion, contraction, and shrink coefficients
+	void coefficients(Real rho_, Real chi_, Real gamma_, Real sigma_)
+	{
+		ASSERT( rho_ > 0 );
+		ASSERT( chi_ > 1 );
+		ASSERT( chi_ > rho_ );
+		ASSERT( (0 < gamma_) and (gamma_ < 1) );
+		ASSERT( (0 < sigma_) and (sigma_ < 1) );
+		rho = rho_;
+		chi = chi_;
+		gamma = gamma_;
+		sigma = sigma_;
+	}
+
+	//! Enables (or disables) speculative, concurrent evaluation of the candidates
+	/*!
+	 *	The cost function must then be safe to call concurrently.
+	 */
+	void parallelEvaluation(bool par_) {par = par_;}
+
+	//! Returns true if candidates are evaluated concurrently
+	bool parallelEvaluation() const {return par;}
+
+	//! Returns the vertices (one per column)
+	const linalg::Matrix<Real>& simplex() const {return xs;}
+
+	//! Returns the cost at vertex j
+	Real vertexCost(Index j) const {return fs(j);}
+
+	//! Returns the number of cost function evaluations since the last newSequence
+	Size evaluations() const {return nevals;}
+
+	//! Returns the spread of the vertex costs
+	Real costSpread() const
+	{
+		Real fmax = fs(0);
+		for(Index j=1; j<=dim; ++j)
+			fmax = numlib::max(fmax, fs(j));
+		return fmax - fs(ilo);
+	}
+
+	//! Returns the size of the simplex (max distance of a vertex from the best, per coordinate)
+	Real simplexSize() const
+	{
+		Real d = 0.0;
+		for(Index j=0; j<=dim; ++j)
+			for(Index i=0; i<dim; ++i)
+				d = numlib::max(d, std::fabs(xs(i,j) - xs(i,ilo)));
+		return d;
+	}
+
+	//! Resets optimizer to begin a new iteration sequence
+	/*!
+	 *	The initial simplex has the vertex min.design(), and the vertices
+	 *	min.design() + step*e_i. The cost of the initial design is evaluated
+	 *	(with the other vertices) and stored in min.
+	 */
+	ErrorCode newSequence(FunctionType& f, Minimum& min)
+	{
+		ASSERT( min.size() == dim );
+
+		const VectorType& x0 = min.design();
+
+		for(Index j=0; j<=dim; ++j)
+			for(Index i=0; i<dim; ++i)
+				xs(i,j) = x0(i);
+
+		for(Index j=1; j<=dim; ++j)
+			xs(j-1,j) += step;
+
+		nevals = 0;
+
+		evaluateVertices(f, 0);
+
+		min.design(x0, fs(0));
+
+		ilo = 0;
+		for(Index j=1; j<=dim; ++j)
+			if(fs(j) < fs(ilo))
+				ilo = j;
+
+		return SUCCESS;
+	}
+
+	//! Executes one iteration: replaces the worst vertex, or shrinks the simplex
+	ErrorCode iter(FunctionType& f, Minimum& min)
+	{
+		// Locate worst and second worst vertices...
+
+		Index ihi = (ilo == 0) ? 1 : 0;
+		for(Index j=0; j<=dim; ++j)
+			if(fs(j) > fs(ihi))
+				ihi = j;
+
+		Index isec = ilo;
+		for(Index j=0; j<=dim; ++j)
+			if( (j != ihi) and (fs(j) > fs(isec)) )
+				isec = j;
+
+		// Compute centroid of all vertices but the worst...
+
+		for(Index i=0; i<dim; ++i)
+		{
+			Real s = 0.0;
+			for(Index j=0; j<=dim; ++j)
+				if(j != ihi) s += xs(i,j);
+			xbar(i) = s/dim;
+		}
+
+		// Set up candidates...
+
+		const Real coef[4] = {rho, rho*chi, gamma*rho, -gamma};
+
+		for(Index k=0; k<4; ++k)
+		{
+			for(Index i=0; i<dim; ++i)
+				xc[k](i) = xbar(i) + coef[k]*(xbar(i) - xs(i,ihi));
+			evaluated(k) = false;
+		}
+
+		if(par)
+		{
+			#pragma omp parallel for schedule(dynamic)
+			for(int k=0; k<4; ++k)
+				fc(k) = f(xc[k]);
+
+			nevals += 4;
+			for(Index k=0; k<4; ++k)
+				evaluated(k) = true;
+		}
+
+		// Choose replacement of the worst vertex...
+
+		const Real fl = fs(ilo);
+		const Real fsec = fs(isec);
+		const Real fh = fs(ihi);
+
+		Index knew = 4;
+
+		const Real fr = candidateCost(f, REFLECTION);
+
+		if(fr < fl)
+		{
+			knew = (candidateCost(f, EXPANSION) < fr) ? EXPANSION : REFLECTION;
+		}
+		else if(fr < fsec)
+		{
+			knew = REFLECTION;
+		}
+		else if(fr < fh)
+		{
+			if(not (candidateCost(f, OUTSIDE_CONTRACTION) > fr)) knew = OUTSIDE_CONTRACTION;
+		}
+		else
+		{
+			if(candidateCost(f, INSIDE_CONTRACTION) < fh) knew = INSIDE_CONTRACTION;
+		}
+
+		if(knew < 4)
+		{
+			for(Index i=0; i<dim; ++i)
+				xs(i,ihi) = xc[knew](i);
+			fs(ihi) = fc(knew);
+
+			if(fs(ihi) < fs(ilo)) ilo = ihi;
+		}
+		else
+		{
+			// Shrink towards the best vertex...
+
+			for(Index j=0; j<=dim; ++j)
+				if(j != ilo)
+					for(Index i=0; i<dim; ++i)
+						xs(i,j) = xs(i,ilo) + sigma*(xs(i,j) - xs(i,ilo));
+
+			evaluateVertices(f, 0, ilo);
+
+			for(Index j=0; j<=dim; ++j)
+				if(fs(j) < fs(ilo))
+					ilo = j;
+		}
+
+		// Update optimum estimate...
+
+		VectorType& x = xt[0];
+		getVertex(ilo, x);
+		min.design(x, fs(ilo));
+
+		return SUCCESS;
+	}
+
+	//! Executes a complete optimization sequence until convergence or failure
+	/*!
+	 *  This is essentially a wrapper around OptimizerNM::newSequence and
+	 *  OptimizerNM::iter, which terminates when both the spread of the
+	 *  vertex costs and the size of the simplex are less than their
+	 *  tolerances.
+	 */
+	ErrorCode minimize(FunctionType& f, Minimum& min)
+	{
+		ErrorCode code = newSequence(f, min);
+
+		if(code!=SUCCESS) return code;
+
+		for(Index n=0; n<max_iter; ++n)
+		{
+			code = iter(f, min);
+			if(code!=SUCCESS) return code;
+
+			if( (costSpread() < tol) and (simplexSize() < tol_x) ) return SUCCESS;
+		}
+
+		return EXCEEDED_MAX_ITER;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( OptimizerNM );
+
+	//! Candidate replacements of the worst vertex
+	enum Candidate {REFLECTION, EXPANSION, OUTSIDE_CONTRACTION, INSIDE_CONTRACTION};
+
+	//! Number of design variables
+	Size dim;
+
+	//! Termination parameters
+	Real tol, tol_x;
+	Size max_iter;
+
+	//! Edge length of the initial simplex
+	Real step;
+
+	//! Reflection, expansion, contraction, and shrink coefficients
+	Real rho, chi, gamma, sigma;
+
+	//! Parallel evaluation flag
+	bool par;
+
+	//! Number of cost function evaluations
+	Size nevals;
+
+	//! Vertices (one per column) and their costs
+	linalg::Matrix<Real> xs;
+	array::Array1D<Real> fs;
+
+	//! Centroid
+	array::Array1D<Real> xbar;
+
+	//! Candidate costs, and flags of evaluated candidates
+	array::Array1D<Real> fc;
+	array::Array1D<bool> evaluated;
+
+	//! Candidates
+	std::vector<VectorType> xc;
+
+	//! Per-thread work vectors
+	std::vector<VectorType> xt;
+
+	//! Best vertex
+	Index ilo;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Copies vertex j to vector x
+	void getVertex(Index j, VectorType& x) const
+	{
+		for(Index i=0; i<dim; ++i)
+			x(i) = xs(i,j);
+	}
+
+	// Returns the cost of candidate k, evaluating it if needed
+	Real candidateCost(FunctionType& f, Index k)
+	{
+		if(not evaluated(k))
+		{
+			fc(k) = f(xc[k]);
+			evaluated(k) = true;
+			++nevals;
+		}
+		return fc(k);
+	}
+
+	// Evaluates the costs of vertices first, ..., dim (except vertex skip)
+	void evaluateVertices(FunctionType& f, Index first, Index skip=Index(-1))
+	{
+		if(par)
+		{
+			const Size nt = maxThreads();
+			if(xt.size() < nt) xt.resize(nt, VectorType(dim));
+
+			#pragma omp parallel for schedule(dynamic) num_threads(nt)
+			for(int j=int(first); j<=int(dim); ++j)
+			{
+				if(Index(j) == skip) continue;
+				VectorType& x = xt[threadIndex()];
+				getVertex(j, x);
+				fs(j) = f(x);
+			}
+		}
+		else
+		{
+			for(Index j=first; j<=dim; ++j)
+			{
+				if(j == skip) continue;
+				getVertex(j, xt[0]);
+				fs(j) = f(xt[0]);
+			}
+		}
+
+		nevals += dim + 1 - first - ((skip >= first) and (skip <= dim) ? 1 : 0);
+	}
+
+};
+
+}}//::numlib::optimization
+
+#endif
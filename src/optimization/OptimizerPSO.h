@@ -5,7 +5,10 @@
 #ifndef OPTIMIZER_PSO_H
 #define OPTIMIZER_PSO_H
 
+#include <limits>
+#include "../base/nocopy.h"
 #include "../base/random.h"
+#include "../array/Array1D.h"
 #include "../array/PointerArray.h"
 
 #include "optimization_error_codes.h"
@@ -46,6 +49,20 @@ namespace numlib{ namespace optimization{
  *	iterations since last change in gbest would be a better stopping
  *	criterion?
  *
+ *	By default, particles are advanced (and their costs evaluated) one at
+ *	a time, as above. In parallel mode (see parallelEvaluation) each
+ *	iteration is instead performed in phases: the random numbers of every
+ *	particle are drawn, in particle order, from a generator owned by the
+ *	optimizer; all particles are then moved, and their costs evaluated,
+ *	concurrently; finally, the personal and global bests are updated in
+ *	particle order. Since all particles move relative to the global best of
+ *	the previous iteration, and neither the random numbers nor the
+ *	reductions depend on the thread schedule, the result depends only on
+ *	the seed (see seed), not on the number of threads. The cost function
+ *	must then be safe to call concurrently. Alternatively, the costs may be
+ *	evaluated by a user supplied batch evaluator (e.g. one which dispatches
+ *	to an external job scheduler); see iterBatch.
+ *
  *	\todo Find better container type for swarm - one with a proper iterator
  *	would be nice.
  *
@@ -63,8 +80,15 @@ public:
 	typedef P ParticleType;
 	typedef MinimumND<VectorType> Minimum;
 
+	//! Particle positions passed to batch evaluators
+	typedef array::Array1D<const VectorType*> PositionArray;
+
+	//! Particle costs returned by batch evaluators
+	typedef array::Array1D<Real> CostArray;
+
 	OptimizerPSO(Size dim, Size np, Real tol_=5.0E-3, Size max_count_=10, Size max_iter_=1000):
-		swarm(np),gbest(NULL), tol(tol_), max_count(max_count_), max_iter(max_iter_)
+		swarm(np),gbest(NULL), tol(tol_), max_count(max_count_), max_iter(max_iter_),
+		par(false), rseed(1), positions(np), costs(np), r1(np), r2(np)
 	{
 		for(Index i=0; i<np; ++i)
 			swarm[i] = new ParticleType(dim, i);
@@ -96,9 +120,27 @@ public:
 			swarm[i]->maxVelocity(vmax);
 	}
 
+	//! Enables/disables concurrent evaluation of the swarm (see class description)
+	void parallelEvaluation(bool par_) {par = par_;}
+
+	//! Returns true if the swarm is evaluated concurrently
+	bool parallelEvaluation() const {return par;}
+
+	//! Sets the seed used by parallel and batch evaluation
+	void seed(unsigned long rseed_) {rseed = rseed_;}
+
+	//! Returns the seed used by parallel and batch evaluation
+	unsigned long seed() const {return rseed;}
+
 	//! Initializes particle positions and velocities in the design space
 	ErrorCode newSequence(FunctionType& f, Minimum& min)
 	{
+		if(par)
+		{
+			FunctionBatch batch(f);
+			return newSequenceBatch(batch, min);
+		}
+
 		// Re-seed random number generator ...
 
 		randomSeed();
@@ -122,21 +164,9 @@ public:
 			swarm[i]->newSequence(f(pos0), pos0, vel0);
 		}
 
-		// Find best...
-
-		gbest = swarm[0];
-		for(Index i=1; i<swarm.size(); ++i)
-		{
-			if(gbest->bestCost() > swarm[i]->bestCost())
-				gbest = swarm[i];
-		}
+		// Find and set best...
 
-		// Set best...
-
-		for(Index i=0; i<swarm.size(); ++i)
-			swarm[i]->bestParticle(gbest);
-
-		min.design( gbest->bestPosition(), gbest->bestCost() );
+		updateBest(min);
 
 		return SUCCESS;
 	}
@@ -144,28 +174,20 @@ public:
 	//! Advances the dynamics of the swarm one time level
 	ErrorCode iter(FunctionType& f, Minimum& min)
 	{
-		// Advance swarm...
-
-		for(Index i=0; i<swarm.size(); ++i)
-			swarm[i]->iter(f);
-
-		// Find best...
-
-		gbest = swarm[0];
-		for(Index i=1; i<swarm.size(); ++i)
+		if(par)
 		{
-			if(gbest->bestCost() > swarm[i]->bestCost())
-				gbest = swarm[i];
+			FunctionBatch batch(f);
+			return iterBatch(batch, min);
 		}
 
-		// Set best...
+		// Advance swarm...
 
 		for(Index i=0; i<swarm.size(); ++i)
-			swarm[i]->bestParticle(gbest);
+			swarm[i]->iter(f);
 
-		// Update solution..
+		// Find and set best, and update solution...
 
-		min.design( gbest->bestPosition(), gbest->bestCost() );
+		updateBest(min);
 
 		return SUCCESS;
 
@@ -186,25 +208,129 @@ public:
 
 			if(code!=SUCCESS) return code;
 
-			Real delta_f = fopt - min.cost();
+			if(converged(fopt, min, count)) return SUCCESS;
 
-			ASSERT( !(delta_f < 0) );
+		}
 
-			if(delta_f < tol) 
-				count++;
-			else
-				count = 0;
+		return EXCEEDED_MAX_ITER;
+
+	}
 
-			if(count > max_count)
+	//! Initializes the swarm, with costs evaluated by a batch evaluator
+	/*!
+	 *	The batch evaluator implements
+	 *
+	 *		void operator()(const PositionArray& x, CostArray& fx);
+	 *
+	 *	which sets fx(i) to the cost at *x(i) for all i. Unlike newSequence
+	 *	(in serial mode), the cost of every initial position is evaluated,
+	 *	including that of min.design(). The initial positions and velocities
+	 *	are drawn from the seeded generator (see seed).
+	 */
+	template<class B>
+	ErrorCode newSequenceBatch(B& batch, Minimum& min)
+	{
+		const Size np = swarm.size();
+
+		rng.seed(rseed);
+
+		VectorType pos0(min.design().size());
+		VectorType vel0(min.design().size());
+
+		// Initialize particles (costs are set once evaluated)...
+
+		const Real unset = std::numeric_limits<Real>::max();
+
+		for(Index i=0; i<np; ++i)
+		{
+			if(i == 0)
+			{
+				pos0 = min.design();
+			}
+			else
 			{
-				min.design( gbest->bestPosition(), gbest->bestCost() );
-				return SUCCESS;
+				rng.vector(pos0, -1.0, 1.0);
+				pos0 += min.design(); /* center swarm about initial guess */
 			}
+			rng.vector(vel0, -0.1, 0.1);
 
+			swarm[i]->newSequence(unset, pos0, vel0);
+			positions(i) = &swarm[i]->position();
 		}
 
-		return EXCEEDED_MAX_ITER;
+		// Evaluate costs...
+
+		batch(positions, costs);
+
+		for(Index i=0; i<np; ++i)
+			swarm[i]->cost(costs(i));
+
+		updateBest(min);
+
+		return SUCCESS;
+	}
+
+	//! Advances the swarm one time level, with costs evaluated by a batch evaluator
+	/*!
+	 *	See newSequenceBatch for the batch evaluator interface.
+	 */
+	template<class B>
+	ErrorCode iterBatch(B& batch, Minimum& min)
+	{
+		const Size np = swarm.size();
+
+		// Draw random numbers in particle order...
+
+		for(Index i=0; i<np; ++i)
+		{
+			r1(i) = rng.number();
+			r2(i) = rng.number();
+		}
+
+		// Move particles (relative to the current best)...
+
+		#pragma omp parallel for
+		for(Index i=0; i<np; ++i)
+			swarm[i]->move(r1(i), r2(i));
+
+		// Evaluate costs...
+
+		for(Index i=0; i<np; ++i)
+			positions(i) = &swarm[i]->position();
 
+		batch(positions, costs);
+
+		// Update personal and global best...
+
+		for(Index i=0; i<np; ++i)
+			swarm[i]->cost(costs(i));
+
+		updateBest(min);
+
+		return SUCCESS;
+	}
+
+	//! Executes a complete optimization sequence, with costs evaluated by a batch evaluator
+	template<class B>
+	ErrorCode minimizeBatch(B& batch, Minimum& min)
+	{
+		ErrorCode code = newSequenceBatch(batch, min);
+
+		if(code!=SUCCESS) return code;
+
+		Index count(0);
+		for(Index n=0; n<max_iter; ++n)
+		{
+			Real fopt = min.cost();
+
+			code = iterBatch(batch, min);
+
+			if(code!=SUCCESS) return code;
+
+			if(converged(fopt, min, count)) return SUCCESS;
+		}
+
+		return EXCEEDED_MAX_ITER;
 	}
 
 private:
@@ -223,6 +349,77 @@ private:
 
 	Size max_iter;
 
+	//! Parallel evaluation flag
+	bool par;
+
+	//! Seed used by parallel and batch evaluation
+	unsigned long rseed;
+
+	//! Random number generator used by parallel and batch evaluation
+	RandomGenerator rng;
+
+	//! Particle positions and costs (batch evaluation)
+	PositionArray positions;
+	CostArray costs;
+
+	//! Random numbers of each particle (batch evaluation)
+	array::Array1D<Real> r1, r2;
+
+	//! Batch evaluator which evaluates the cost function concurrently
+	struct FunctionBatch
+	{
+		FunctionBatch(FunctionType& f_): f(f_) {}
+
+		void operator()(const PositionArray& x, CostArray& fx)
+		{
+			#pragma omp parallel for schedule(dynamic)
+			for(Index i=0; i<x.size(); ++i)
+				fx(i) = f(*x(i));
+		}
+
+		FunctionType& f;
+	};
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Finds the global best (lowest index on ties), and shares it with the swarm
+	void updateBest(Minimum& min)
+	{
+		gbest = swarm[0];
+		for(Index i=1; i<swarm.size(); ++i)
+		{
+			if(gbest->bestCost() > swarm[i]->bestCost())
+				gbest = swarm[i];
+		}
+
+		for(Index i=0; i<swarm.size(); ++i)
+			swarm[i]->bestParticle(gbest);
+
+		min.design( gbest->bestPosition(), gbest->bestCost() );
+	}
+
+	// Checks stopping criterion (see class description)
+	bool converged(Real fopt, Minimum& min, Index& count)
+	{
+		Real delta_f = fopt - min.cost();
+
+		ASSERT( !(delta_f < 0) );
+
+		if(delta_f < tol) 
+			count++;
+		else
+			count = 0;
+
+		if(count > max_count)
+		{
+			min.design( gbest->bestPosition(), gbest->bestCost() );
+			return true;
+		}
+
+		return false;
+	}
+
 };
 
 }}//::numlib::optimization
@@ -0,0 +1,462 @@
+/*! \file OptimizerPSOSoA.h
+ *  \brief OptimizerPSOSoA class template definition
+ */
+
+#ifndef OPTIMIZER_PSO_SOA_H
+#define OPTIMIZER_PSO_SOA_H
+
+#include <cmath>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/parallel_tools.h"
+#include "../base/random.h"
+#include "../array/Array1D.h"
+#include "../linalg/Matrix.h"
+
+#include "optimization_error_codes.h"
+#include "MinimumND.h"
+
+namespace numlib{ namespace optimization{
+
+//! Particle Swarm Optimization (PSO) with struct-of-arrays swarm storage
+/*!
+ *	Implements the same algorithm, particle model, and parameters as
+ *	OptimizerPSO (with Particle), but stores the positions, velocities, and
+ *	personal best positions of the whole swarm in three dim x np matrices
+ *	(one column per particle) instead of one Particle object per particle.
+ *	The velocity update, constriction, and position update of the swarm is
+ *	a single sweep over these matrices, without temporaries, parallelized
+ *	over the particles. For high dimensional swarms (e.g. dim >= 1000) this
+ *	is considerably faster than OptimizerPSO, whose update otherwise rivals
+ *	the cost of inexpensive cost functions.
+ *
+ *	Iterations are always performed in phases, as for the parallel mode of
+ *	OptimizerPSO: all particles move relative to the global best of the
+ *	previous iteration, the random numbers are drawn in particle order from
+ *	a seeded generator, and the bests are reduced in particle order; thus,
+ *	the result depends only on the seed. The costs may be evaluated one at
+ *	a time, concurrently (see parallelEvaluation), or by a batch evaluator
+ *	(see iterBatch). The position of each particle is copied to a work
+ *	vector of type V for evaluation.
+ */
+template<class F, class V>
+class OptimizerPSOSoA
+{
+public:
+
+	typedef F FunctionType;
+	typedef V VectorType;
+	typedef MinimumND<VectorType> Minimum;
+
+	//! Particle positions passed to batch evaluators
+	typedef array::Array1D<const VectorType*> PositionArray;
+
+	//! Particle costs returned by batch evaluators
+	typedef array::Array1D<Real> CostArray;
+
+	OptimizerPSOSoA(Size dim_, Size np_, Real tol_=5.0E-3, Size max_count_=10, Size max_iter_=1000):
+		dim(dim_), np(np_), tol(tol_), max_count(max_count_), max_iter(max_iter_),
+		vmax(0.5), w(0.0), c1(1.5), c2(2.5), par(false), rseed(1),
+		pos(dim_, np_), vel(dim_, np_), pbest_pos(dim_, np_), cst(np_), pbest_cst(np_),
+		gbest(0), r1(np_), r2(np_), xt(0), nxt(0), xb(0), positions(0), costs(np_)
+	{
+		ASSERT( np > 0 );
+
+		threadWork(maxThreads());
+	}
+
+	~OptimizerPSOSoA()
+	{
+		delete[] xt;
+		delete[] xb;
+	}
+
+	//! Returns the number of particles
+	Size size() const {return np;}
+
+	//! Sets the inertia of each particle (see Particle::inertia)
+	void inertia(const Real w_) {w = w_;}
+
+	//! Sets maximum velocity of each particle
+	void maxVelocity(const Real vmax_) {vmax = vmax_;}
+
+	//! Sets confidence of each particle in its own best
+	void selfTrust(const Real c1_) {c1 = c1_;}
+
+	//! Sets confidence of each particle in the global best
+	void swarmTrust(const Real c2_) {c2 = c2_;}
+
+	//! Enables/disables concurrent evaluation of the swarm
+	/*!
+	 *	The cost function must then be safe to call concurrently. This does
+	 *	not change the result.
+	 */
+	void parallelEvaluation(bool par_) {par = par_;}
+
+	//! Returns true if the swarm is evaluated concurrently
+	bool parallelEvaluation() const {return par;}
+
+	//! Sets the seed of the random number generator
+	void seed(unsigned long rseed_) {rseed = rseed_;}
+
+	//! Returns the seed of the random number generator
+	unsigned long seed() const {return rseed;}
+
+	//! Returns particle positions (one column per particle)
+	const linalg::Matrix<Real>& positionMatrix() const {return pos;}
+
+	//! Returns particle velocities (one column per particle)
+	const linalg::Matrix<Real>& velocityMatrix() const {return vel;}
+
+	//! Returns personal best positions (one column per particle)
+	const linalg::Matrix<Real>& bestPositionMatrix() const {return pbest_pos;}
+
+	//! Returns the personal best cost of particle i
+	Real bestCost(Index i) const {return pbest_cst(i);}
+
+	//! Returns the index of the particle with the lowest personal best cost
+	Index bestParticle() const {return gbest;}
+
+	//! Replaces the particle with the highest personal best cost by an immigrant
+	/*!
+	 *	The position and personal best of the particle are set to x, of cost
+	 *	fx; its velocity is retained. This is used to exchange particles
+	 *	between swarms (see OptimizerIslandPSO). min is updated if x is the
+	 *	new global best.
+	 */
+	void immigrate(const VectorType& x, Real fx, Minimum& min)
+	{
+		Index k = 0;
+		for(Index j=1; j<np; ++j)
+			if(pbest_cst(j) > pbest_cst(k))
+				k = j;
+
+		for(Index i=0; i<dim; ++i)
+		{
+			pos(i,k) = x(i);
+			pbest_pos(i,k) = x(i);
+		}
+		cst(k) = fx;
+		pbest_cst(k) = fx;
+
+		updateBest(min);
+	}
+
+	//! Initializes particle positions and velocities in the design space
+	ErrorCode newSequence(FunctionType& f, Minimum& min)
+	{
+		FunctionBatch batch(f);
+		return newSequenceBatch(batch, min);
+	}
+
+	//! Advances the dynamics of the swarm one time level
+	ErrorCode iter(FunctionType& f, Minimum& min)
+	{
+		FunctionBatch batch(f);
+		return iterBatch(batch, min);
+	}
+
+	//! Executes a complete optimization sequence (see OptimizerPSO::minimize)
+	ErrorCode minimize(FunctionType& f, Minimum& min)
+	{
+		FunctionBatch batch(f);
+		return minimizeBatch(batch, min);
+	}
+
+	//! Initializes the swarm, with costs evaluated by a batch evaluator
+	/*!
+	 *	See OptimizerPSO::newSequenceBatch for the batch evaluator interface.
+	 *	The swarm is centered about min.design(), as for OptimizerPSO.
+	 */
+	template<class B>
+	ErrorCode newSequenceBatch(B& batch, Minimum& min)
+	{
+		ASSERT( min.design().size() == dim );
+
+		rng.seed(rseed);
+
+		const VectorType& x0 = min.design();
+
+		for(Index j=0; j<np; ++j)
+		{
+			for(Index i=0; i<dim; ++i)
+				pos(i,j) = (j == 0) ? x0(i) : rng.number(-1.0, 1.0) + x0(i);
+
+			Real vn = 0.0;
+			for(Index i=0; i<dim; ++i)
+			{
+				vel(i,j) = rng.number(-0.1, 0.1);
+				vn += vel(i,j)*vel(i,j);
+			}
+			constrict(j, std::sqrt(vn));
+		}
+
+		evaluate(batch);
+
+		for(Index j=0; j<np; ++j)
+		{
+			pbest_cst(j) = cst(j);
+			for(Index i=0; i<dim; ++i)
+				pbest_pos(i,j) = pos(i,j);
+		}
+
+		updateBest(min);
+
+		return SUCCESS;
+	}
+
+	//! Advances the swarm one time level, with costs evaluated by a batch evaluator
+	template<class B>
+	ErrorCode iterBatch(B& batch, Minimum& min)
+	{
+		// Draw random numbers in particle order...
+
+		for(Index j=0; j<np; ++j)
+		{
+			r1(j) = rng.number();
+			r2(j) = rng.number();
+		}
+
+		// Update velocities and positions...
+
+		const Index g = gbest;
+
+		#pragma omp parallel for
+		for(Index j=0; j<np; ++j)
+		{
+			const Real a1 = c1*r1(j);
+			const Real a2 = c2*r2(j);
+
+			Real vn = 0.0;
+			for(Index i=0; i<dim; ++i)
+			{
+				const Real xi = pos(i,j);
+				const Real vi = w*vel(i,j) + a1*(pbest_pos(i,j) - xi) + a2*(pbest_pos(i,g) - xi);
+				vel(i,j) = vi;
+				vn += vi*vi;
+			}
+
+			constrict(j, std::sqrt(vn));
+
+			for(Index i=0; i<dim; ++i)
+				pos(i,j) += vel(i,j);
+		}
+
+		// Evaluate costs...
+
+		evaluate(batch);
+
+		// Update personal and global best...
+
+		for(Index j=0; j<np; ++j)
+		{
+			if(cst(j) < pbest_cst(j))
+			{
+				pbest_cst(j) = cst(j);
+				for(Index i=0; i<dim; ++i)
+					pbest_pos(i,j) = pos(i,j);
+			}
+		}
+
+		updateBest(min);
+
+		return SUCCESS;
+	}
+
+	//! Executes a complete optimization sequence, with costs evaluated by a batch evaluator
+	template<class B>
+	ErrorCode minimizeBatch(B& batch, Minimum& min)
+	{
+		ErrorCode code = newSequenceBatch(batch, min);
+
+		if(code!=SUCCESS) return code;
+
+		Index count(0);
+		for(Index n=0; n<max_iter; ++n)
+		{
+			Real fopt = min.cost();
+
+			code = iterBatch(batch, min);
+
+			if(code!=SUCCESS) return code;
+
+			Real delta_f = fopt - min.cost();
+
+			ASSERT( !(delta_f < 0) );
+
+			if(delta_f < tol)
+				count++;
+			else
+				count = 0;
+
+			if(count > max_count) return SUCCESS;
+		}
+
+		return EXCEEDED_MAX_ITER;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( OptimizerPSOSoA );
+
+	//! Number of design variables
+	Size dim;
+
+	//! Number of particles
+	Size np;
+
+	Real tol;
+
+	Size max_count;
+
+	Size max_iter;
+
+	//! Particle parameters (see Particle)
+	Real vmax, w, c1, c2;
+
+	//! Parallel evaluation flag
+	bool par;
+
+	//! Seed of the random number generator
+	unsigned long rseed;
+
+	//! Random number generator
+	RandomGenerator rng;
+
+	//! Particle positions, velocities, and personal best positions
+	linalg::Matrix<Real> pos, vel, pbest_pos;
+
+	//! Particle costs and personal best costs
+	array::Array1D<Real> cst, pbest_cst;
+
+	//! Index of the particle with the lowest personal best cost
+	Index gbest;
+
+	//! Random numbers of each particle
+	array::Array1D<Real> r1, r2;
+
+	//! Work vectors of each thread (evaluation of the cost function)
+	VectorType* xt;
+
+	//! Number of thread work vectors
+	Size nxt;
+
+	//! Work vectors of each particle (batch evaluation)
+	VectorType* xb;
+
+	//! Particle positions and costs (batch evaluation)
+	PositionArray positions;
+	CostArray costs;
+
+	//! Batch evaluator which evaluates the cost function (concurrently in parallel mode)
+	struct FunctionBatch
+	{
+		FunctionBatch(FunctionType& f_): f(f_) {}
+
+		FunctionType& f;
+	};
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Scales the velocity of particle j (of norm vn) to the maximum velocity
+	void constrict(Index j, Real vn)
+	{
+		if(vn > vmax)
+		{
+			const Real s = vmax/vn;
+			for(Index i=0; i<dim; ++i)
+				vel(i,j) *= s;
+		}
+	}
+
+	// Copies the position of particle j to vector x
+	void getPosition(Index j, VectorType& x) const
+	{
+		for(Index i=0; i<dim; ++i)
+			x(i) = pos(i,j);
+	}
+
+	// Ensures a work vector is available to each of nt threads
+	void threadWork(Size nt)
+	{
+		if(nt <= nxt) return;
+
+		delete[] xt;
+		xt = new VectorType[nt];
+		for(Index t=0; t<nt; ++t)
+			xt[t].resize(dim);
+		nxt = nt;
+	}
+
+	// Evaluates the costs of all particles with the cost function
+	void evaluate(FunctionBatch& batch)
+	{
+		if(par)
+		{
+			const Size nt = maxThreads();
+			threadWork(nt);
+
+			#pragma omp parallel for schedule(dynamic) num_threads(nt)
+			for(Index j=0; j<np; ++j)
+			{
+				VectorType& x = xt[threadIndex()];
+				getPosition(j, x);
+				cst(j) = batch.f(x);
+			}
+		}
+		else
+		{
+			for(Index j=0; j<np; ++j)
+			{
+				getPosition(j, xt[0]);
+				cst(j) = batch.f(xt[0]);
+			}
+		}
+	}
+
+	// Evaluates the costs of all particles with a batch evaluator
+	template<class B>
+	void evaluate(B& batch)
+	{
+		if(xb == 0)
+		{
+			xb = new VectorType[np];
+			positions.resize(np);
+			for(Index j=0; j<np; ++j)
+			{
+				xb[j].resize(dim);
+				positions(j) = &xb[j];
+			}
+		}
+
+		for(Index j=0; j<np; ++j)
+			getPosition(j, xb[j]);
+
+		batch(positions, costs);
+
+		for(Index j=0; j<np; ++j)
+			cst(j) = costs(j);
+	}
+
+	// Finds the global best (lowest index on ties), and updates min
+	void updateBest(Minimum& min)
+	{
+		gbest = 0;
+		for(Index j=1; j<np; ++j)
+			if(pbest_cst(gbest) > pbest_cst(j))
+				gbest = j;
+
+		VectorType& x = xt[0];
+		for(Index i=0; i<dim; ++i)
+			x(i) = pbest_pos(i,gbest);
+
+		min.design(x, pbest_cst(gbest));
+	}
+
+};
+
+}}//::numlib::optimization
+
+#endif
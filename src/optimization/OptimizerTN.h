@@ -0,0 +1,330 @@
+/*! \file OptimizerTN.h
+ *  \brief OptimizerTN template definition
+ */
+
+#ifndef OPTIMIZER_TN_H
+#define OPTIMIZER_TN_H
+
+#include <cmath>
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/nocopy.h"
+#include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
+#include "optimization_error_codes.h"
+#include "MinimumND.h"
+#include "HessianFD.h"
+
+namespace numlib{ namespace optimization{
+
+//! Multi-variate optimizer based on the truncated Newton (Hessian-free) algorithm
+/*!
+ *  Each iteration approximately minimizes the quadratic model
+ *
+ *     m(p) = f + g*p + 0.5*p*H*p
+ *
+ *  within a trust region, |p| <= delta, by the conjugate gradient method of
+ *  Steihaug (Steihaug, T. "The Conjugate Gradient Method and Trust Regions
+ *  in Large Scale Optimization." SIAM J. Numer. Anal. Vol. 20, No. 3,
+ *  pp. 626-637, 1983). The CG iteration is truncated when the model
+ *  gradient is reduced by the forcing factor min(0.5, sqrt(|g|)), when the
+ *  iterate leaves the trust region, or when a direction of negative (or
+ *  zero) curvature is encountered; in the last two cases the step is taken
+ *  to the trust region boundary. The Hessian-vector products are evaluated
+ *  by HessianFD; i.e. one gradient evaluation per CG iteration.
+ *
+ *  The step is accepted if the actual reduction of f is at least a small
+ *  fraction of the reduction predicted by the model; the trust region is
+ *  expanded or contracted according to the agreement between the two.
+ *  Compared with OptimizerCG, far fewer (outer) iterations, and line
+ *  searches, are required on ill-conditioned problems.
+ *
+ *  The cost function implements the interface of CostFunctionND; i.e.
+ *  f(x) returns the cost, and f(x, grad) computes the gradient. All work
+ *  vectors are allocated at construction.
+ */
+template<class CostFunction>
+class OptimizerTN
+{
+public:
+
+	typedef typename CostFunction::VectorType VectorType;
+
+	typedef MinimumND<VectorType> Minimum;
+
+	//! Initializes optimizer
+	/*!
+	 *  Arguments:
+	 *    dim: number of design variables
+	 *    f: cost function
+	 *    tol_: gradient norm used to terminate OptimizerTN::minimize
+	 *    max_iter_: maximum number of iterations
+	 */
+	OptimizerTN(Size dim, CostFunction& f, Real tol_=1.0E-6, Size max_iter_=1000):
+		n(dim), tol(tol_), max_iter(max_iter_), max_cg(dim), delta0(1.0),
+		delta(1.0), delta_max(1.0E3), eta_accept(1.0E-4), cg_iter(0),
+		neg_curv(false), hess(f, dim), x(dim), grad(dim), xtrial(dim),
+		p(dim), r(dim), d(dim), hd(dim), hp(dim)
+	{}
+
+	//! Sets convergence tolerance (gradient norm) used to terminate OptimizerTN::minimize
+	void tolerance(Real tol_) {tol = tol_;}
+
+	//! Returns tolerance used to terminate OptimizerTN::minimize
+	Real tolerance() const {return tol;}
+
+	//! Sets maximum allowable iterations executed by OptimizerTN::minimize
+	void maxIteration(Size max_iter_) {max_iter = max_iter_;}
+
+	//! Returns maximum allowable iterations executed by OptimizerTN::minimize
+	Size maxIteration() const {return max_iter;}
+
+	//! Sets maximum number of CG iterations per (outer) iteration
+	void maxCGIteration(Size max_cg_) {max_cg = max_cg_;}
+
+	//! Returns maximum number of CG iterations per (outer) iteration
+	Size maxCGIteration() const {return max_cg;}
+
+	//! Sets initial and maximum trust region radius
+	void trustRadius(Real delta0_, Real delta_max_)
+	{
+		ASSERT( delta0_ > 0 );
+		ASSERT( delta_max_ >= delta0_ );
+		delta0 = delta0_;
+		delta_max = delta_max_;
+	}
+
+	//! Returns current trust region radius
+	Real trustRadius() const {return delta;}
+
+	//! Returns number of CG iterations executed by the last iteration
+	Size cgIterations() const {return cg_iter;}
+
+	//! Returns true if the last iteration encountered negative curvature
+	bool negativeCurvature() const {return neg_curv;}
+
+	//! Returns norm of the gradient at the current design
+	Real gradientNorm() const {return norm2(grad);}
+
+	//! Resets optimizer to begin a new iteration sequence
+	/*!
+	 *  The cost of the initial design, min.design(), is evaluated and
+	 *  stored in min.
+	 */
+	ErrorCode newSequence(CostFunction& f, Minimum& min)
+	{
+		ASSERT( min.size() == n );
+
+		x = min.design();
+		min.design(x, f(x));
+		f(x, grad);
+		delta = delta0;
+
+		return SUCCESS;
+	}
+
+	//! Executes one iteration: refines the optimum design estimate
+	/*!
+	 *  If the trial step is rejected, the design is unchanged (and the trust
+	 *  region is contracted). NO_MIN is returned if the trust region
+	 *  collapses without the gradient vanishing.
+	 */
+	ErrorCode iter(CostFunction& f, Minimum& min)
+	{
+		const Real fopt = min.cost();
+
+		// Approximately minimize the quadratic model...
+
+		hess.bind(x, grad);
+		const Real pred = steihaugCG();
+
+		if(not (pred > 0))
+			return (norm2(grad) < tol) ? SUCCESS : NO_MIN;
+
+		// Evaluate trial step...
+
+		xtrial  = x;
+		xtrial += p;
+		const Real ftrial = f(xtrial);
+		const Real rho = (fopt - ftrial)/pred;
+		const Real pn = norm2(p);
+
+		DEBUG_PRINT_VAR( rho );
+
+		// Update trust region...
+
+		if(not (rho >= 0.25))
+			delta = 0.25*pn;
+		else if( (rho > 0.75) and (pn > 0.99*delta) )
+			delta = numlib::min(2.0*delta, delta_max);
+
+		// Accept or reject step...
+
+		if(rho > eta_accept)
+		{
+			x.swap(xtrial);
+			f(x, grad);
+			min.design(x, ftrial);
+		}
+
+		if(delta < 1.0E-14*(1.0 + norm2(x)))
+			return NO_MIN;
+
+		return SUCCESS;
+	}
+
+	//! Executes a complete optimization sequence until convergence or failure
+	/*!
+	 *  This is essentially a wrapper around OptimizerTN::newSequence and
+	 *  OptimizerTN::iter, which terminates when the gradient norm is less
+	 *  than the tolerance.
+	 */
+	ErrorCode minimize(CostFunction& f, Minimum& min)
+	{
+		ErrorCode code = newSequence(f, min);
+
+		if(code!=SUCCESS) return code;
+
+		for(Index k=0; k<max_iter; ++k)
+		{
+			if(norm2(grad) < tol) return SUCCESS;
+
+			code = iter(f, min);
+			if(code!=SUCCESS) return code;
+		}
+
+		return (norm2(grad) < tol) ? SUCCESS : EXCEEDED_MAX_ITER;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( OptimizerTN );
+
+	Size n;
+
+	Real tol;
+
+	Size max_iter;
+
+	//! Maximum number of CG iterations
+	Size max_cg;
+
+	//! Initial, current, and maximum trust region radius
+	Real delta0, delta, delta_max;
+
+	//! Minimum ratio of actual to predicted reduction for step acceptance
+	Real eta_accept;
+
+	//! Number of CG iterations executed by last iteration
+	Size cg_iter;
+
+	//! Negative curvature flag
+	bool neg_curv;
+
+	//! Hessian-vector product operator
+	HessianFD<CostFunction> hess;
+
+	//! Current design and gradient
+	VectorType x, grad;
+
+	//! Trial design
+	VectorType xtrial;
+
+	//! Step, CG residual, CG direction, H*d, and H*p
+	VectorType p, r, d, hd, hp;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Computes step p by truncated CG; returns predicted reduction -m(p)+f
+	Real steihaugCG()
+	{
+		const Real gn = norm2(grad);
+		const Real eps = min(0.5, std::sqrt(gn))*gn;
+
+		p.zero();
+		hp.zero();
+		r = grad;        /* model gradient, H*p + g */
+		d = grad;
+		d *= -1.0;
+		neg_curv = false;
+
+		Real rr = prod(r, r);
+
+		for(cg_iter=0; cg_iter<max_cg; )
+		{
+			if(std::sqrt(rr) <= eps) break;
+
+			hess.eval(d, hd);
+			++cg_iter;
+
+			const Real dhd = prod(d, hd);
+
+			if(not (dhd > 0))
+			{
+				neg_curv = true;
+				toBoundary();
+				break;
+			}
+
+			const Real alpha = rr/dhd;
+
+			// Leaving the trust region?
+
+			Real pdn = 0.0;
+			for(Index i=0; i<n; ++i)
+			{
+				const Real pdi = p(i) + alpha*d(i);
+				pdn += pdi*pdi;
+			}
+
+			if(std::sqrt(pdn) >= delta)
+			{
+				toBoundary();
+				break;
+			}
+
+			// CG update...
+
+			for(Index i=0; i<n; ++i)
+			{
+				p(i)  += alpha*d(i);
+				hp(i) += alpha*hd(i);
+				r(i)  += alpha*hd(i);
+			}
+
+			const Real rr_new = prod(r, r);
+			const Real beta = rr_new/rr;
+			rr = rr_new;
+
+			for(Index i=0; i<n; ++i)
+				d(i) = beta*d(i) - r(i);
+		}
+
+		DEBUG_PRINT_VAR( cg_iter );
+
+		// Predicted reduction, -(g*p + 0.5*p*H*p)...
+
+		return -(prod(grad, p) + 0.5*prod(p, hp));
+	}
+
+	// Moves p along d to the trust region boundary (using hd = H*d)
+	void toBoundary()
+	{
+		const Real a = prod(d, d);
+		const Real b = 2.0*prod(p, d);
+		const Real c = prod(p, p) - delta*delta;
+		const Real tau = (-b + std::sqrt(max(b*b - 4.0*a*c, 0.0)))/(2.0*a);
+
+		for(Index i=0; i<n; ++i)
+		{
+			p(i)  += tau*d(i);
+			hp(i) += tau*hd(i);
+		}
+	}
+
+};
+
+}}//::numlib::optimization
+
+#endif
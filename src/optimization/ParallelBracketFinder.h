@@ -0,0 +1,188 @@
+/*! \file ParallelBracketFinder.h
+ *  \brief ParallelBracketFinder class definition
+ */
+
+#ifndef PARALLEL_BRACKET_FINDER_H
+#define PARALLEL_BRACKET_FINDER_H
+
+#include <cstdlib>
+#include <vector>
+#include "../base/numlib-config.h"
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../array/Array1D.h"
+
+#include "optimization_error_codes.h"
+#include "Minimum1D.h"
+
+namespace numlib{ namespace optimization{
+
+//! Estimates the upper and lower bound of the minimum, k points at a time
+/*!
+ *  Parallel version of BracketFinder. The cost function is sampled at
+ *  uniform points alpha0 + i*delta, where alpha0 is the initial estimate
+ *  of the optimum, as for BracketFinder; however, each round extends the
+ *  sampled interval by k points at once, which are evaluated concurrently.
+ *  After each round, the lowest sample (the one nearest alpha0 on ties) is
+ *  located: if its neighbors (beyond any plateau of equal samples) are
+ *  both higher, the minimum is bracketed; otherwise the sampled interval
+ *  is extended on the side of the lowest sample (initially to the right).
+ *  Thus, the search covers k steps per round instead of one.
+ *
+ *  Unlike BracketFinder, several minima within the sampled interval are
+ *  not reported as MULTIPLE_MIN; the lowest is bracketed instead. NO_MIN is
+ *  returned if the search limits are reached. The cost function must be
+ *  safe to call concurrently.
+ *
+ * 	Template parameter CostFunction should either be a callable class (functor)
+ * 	or function pointer.
+ */
+template<class CostFunction>
+class ParallelBracketFinder
+{
+public:
+
+	//! Initilizes parameters used by the bracket method
+	/*!
+	 *  step_size := constant step size used to scan for upper and lower bounds
+	 *  k := number of points evaluated (concurrently) per round
+	 *  lower_bound := lower bound on search domain
+	 *  upper_bound := upper bound on search domain
+	 */
+	ParallelBracketFinder(Real step_size, Size k_=2, Real lower_bound=-2.0E3, Real upper_bound=2.0E3):
+		delta(step_size), k(k_), alpha_min(lower_bound), alpha_max(upper_bound), fnew(k_)
+	{
+		ASSERT( k > 0 );
+	}
+
+	void stepSize(Real step_size) {delta = step_size;}
+
+	Real stepSize() const {return delta;}
+
+	//! Sets number of points evaluated per round
+	void points(Size k_)
+	{
+		ASSERT( k_ > 0 );
+		k = k_;
+		fnew.resize(k);
+	}
+
+	//! Returns number of points evaluated per round
+	Size points() const {return k;}
+
+	void lowerBound(Real lower_bound) {alpha_min = lower_bound;}
+
+	Real lowerBound() const {return alpha_min;}
+
+	void upperBound(Real upper_bound) {alpha_max = upper_bound;}
+
+	Real upperBound() const {return alpha_max;}
+
+	//! Executes bracket method
+	/*!
+	 *  Upon input, the optimum estimate is taken to be the starting point of
+	 *  the search. Upon output, if a minimum was bracketed, the lower and
+	 *  upper bounds of min are set to the neighboring samples of the lowest
+	 *  sample, which becomes the optimum estimate, and SUCCESS is returned.
+	 *  Otherwise min is unchanged, and NO_MIN is returned.
+	 */
+	ErrorCode minimize(CostFunction& f, Minimum1D& min)
+	{
+		// Samples i >= 0 are stored in fr(i), and samples i < 0 in fl(-i-1)...
+
+		alpha0 = min.design();
+		fr.assign(1, min.cost());
+		fl.clear();
+
+		int dir = 1;
+
+		for(;;)
+		{
+			const int ilo = -int(fl.size());
+			const int ihi =  int(fr.size()) - 1;
+
+			// Locate lowest sample, and the plateau of equal samples about it...
+
+			int im = 0;
+			for(int i=ilo; i<=ihi; ++i)
+				if( (sample(i) < sample(im)) or
+					( (sample(i) == sample(im)) and (std::abs(i) < std::abs(im)) ) )
+					im = i;
+
+			int jlo = im;
+			while( (jlo > ilo) and (sample(jlo-1) == sample(im)) ) --jlo;
+
+			int jhi = im;
+			while( (jhi < ihi) and (sample(jhi+1) == sample(im)) ) ++jhi;
+
+			if( (jlo > ilo) and (jhi < ihi) )
+			{
+				/* found bounds on minimum */
+
+				min.lowerBound(point(jlo-1), sample(jlo-1));
+				min.upperBound(point(jhi+1), sample(jhi+1));
+				min.design(point(im), sample(im));
+
+				return SUCCESS;
+			}
+
+			// Extend samples on the side of the lowest sample...
+
+			if( (jlo == ilo) and (jhi < ihi) )
+				dir = -1;
+			else if( (jhi == ihi) and (jlo > ilo) )
+				dir = 1;
+
+			const int edge = (dir > 0) ? ihi : ilo;
+
+			if( (point(edge + dir*int(k)) < alpha_min) or
+				(point(edge + dir*int(k)) > alpha_max) )
+				return NO_MIN;
+
+			#pragma omp parallel for schedule(dynamic)
+			for(int j=0; j<int(k); ++j)
+				fnew(j) = f(point(edge + dir*(j+1)));
+
+			for(Index j=0; j<k; ++j)
+			{
+				if(dir > 0)
+					fr.push_back(fnew(j));
+				else
+					fl.push_back(fnew(j));
+			}
+		}
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( ParallelBracketFinder );
+
+	// Step size
+	Real delta;
+
+	// Number of points per round
+	Size k;
+
+	// Search limits
+	Real alpha_min, alpha_max;
+
+	// Starting point
+	Real alpha0;
+
+	// Samples to the right (including alpha0) and left of alpha0
+	std::vector<Real> fr, fl;
+
+	// Samples of the current round
+	array::Array1D<Real> fnew;
+
+	// Returns sample point i
+	Real point(int i) const {return alpha0 + i*delta;}
+
+	// Returns cost at sample point i
+	Real sample(int i) const {return (i < 0) ? fl[-i-1] : fr[i];}
+
+};
+
+}}//::numlib::optimization
+
+#endif
@@ -131,26 +131,45 @@ public:
 
 	void iter(FunctionType& f)
 	{
-		// Update velocity...
-
 		Real r1 = randomNumber();
 		Real r2 = randomNumber();
 
-		vel *= w;
-		vel += c1*r1*(pbest_pos - pos);
-		vel += c2*r2*(gbest->bestPosition() - pos);
+		move(r1, r2);
+
+		cost(f(pos));
+	}
+
+	//! Updates velocity and position, given random numbers r1 and r2
+	/*!
+	 *	This is the first half of iter; the cost at the new position must
+	 *	then be set (see cost). Separating the two allows the costs of a
+	 *	swarm to be evaluated concurrently. Only this particle, and the
+	 *	personal best of the best particle, are accessed.
+	 */
+	void move(Real r1, Real r2)
+	{
+		// Update velocity...
+
+		const VectorType& gbest_pos = gbest->bestPosition();
+
+		for(Index i=0; i<vel.size(); ++i)
+		{
+			vel(i) *= w;
+			vel(i) += c1*r1*(pbest_pos(i) - pos(i));
+			vel(i) += c2*r2*(gbest_pos(i) - pos(i));
+		}
 
 		constrictionOperator(vel);
 
 		// Update position...
 		
 		pos += vel;
+	}
 
-		// Update cost...
-
-		cst = f(pos);
-
-		// Update personal best...
+	//! Sets the cost at the current position, and updates personal best
+	void cost(Real fp)
+	{
+		cst = fp;
 
 		if(cst < pbest_cst)
 		{
@@ -113,7 +113,7 @@ public:
 			alpha1 = alpha_opt;
 			f1 = f_opt;
 
-		}while(fabs(delta_f) > delta_f_max);
+		}while(std::fabs(delta_f) > delta_f_max);
 
 		// Set optimum estimate
 		min.design(alpha1, f1);
@@ -5,6 +5,8 @@
 #ifndef STRETCHING_OPERATOR_H
 #define STRETCHING_OPERATOR_H
 
+#include <cmath>
+
 namespace numlib{ namespace optimization{
 
 template<class F, class V>
@@ -53,7 +55,47 @@ public:
 
 		gx += gamma_1*r*swch;
 
-		return gx + gamma_2*swch/tanh(mu*(gx - fx_lmin));
+		return gx + gamma_2*swch/std::tanh(mu*(gx - fx_lmin));
+	}
+
+	//! Computes the gradient of the stretched function at x
+	/*!
+	 *	Requires the gradient of f, f(x, grad). Where the cost exceeds that
+	 *	of the local minimum, the chain rule gives
+	 *
+	 *	   dG = df + gamma_1*swch*(x - x_lmin)/r
+	 *	   dH = dG*(1 - gamma_2*swch*mu/sinh^2(mu*(G - fx_lmin)))
+	 *
+	 *	where G and H are the first and second stretching transformations;
+	 *	elsewhere the gradient is that of f.
+	 *
+	 *	Since the gradient interface does not return the cost, each call
+	 *	evaluates f twice: once for its gradient, and once for its value at
+	 *	x. Where f is costly, it may be wrapped in a CachedCostFunction, so
+	 *	that repeated evaluations of its value at x (e.g. by the stretched
+	 *	cost) are served from the cache.
+	 */
+	void operator()(const VectorType& x, VectorType& grad)
+	{
+		f(x, grad);
+
+		Real gx = f(x);
+
+		if(gx < fx_lmin) return;
+
+		Real swch = sgn(gx - fx_lmin) + 1.0;
+
+		Real r = norm2(x - x_lmin);
+
+		if(r > 0)
+			for(Index i=0; i<grad.size(); ++i)
+				grad(i) += gamma_1*swch*(x(i) - x_lmin(i))/r;
+
+		gx += gamma_1*r*swch;
+
+		Real sh = std::sinh(mu*(gx - fx_lmin));
+
+		grad *= 1.0 - gamma_2*swch*mu/(sh*sh);
 	}
 
 private:
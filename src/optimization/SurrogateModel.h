@@ -0,0 +1,311 @@
+/*! \file SurrogateModel.h
+ *  \brief SurrogateModel class template definition
+ */
+
+#ifndef SURROGATE_MODEL_H
+#define SURROGATE_MODEL_H
+
+#include <cmath>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../array/Array1D.h"
+#include "../linalg/Matrix.h"
+
+namespace numlib{ namespace optimization{
+
+//! Gaussian process (kriging) model of a cost function
+/*!
+ *	Interpolates the samples (x_k, f_k) added so far with a Gaussian
+ *	radial basis function, R(x,y) = exp(-|x-y|^2/(2*l^2)), of length scale
+ *	l, and a constant mean; i.e. the predicted cost is
+ *
+ *	   mu(x) = m + r(x)*alpha,   alpha = R^{-1}(f - m),
+ *
+ *	where R_jk = R(x_j,x_k) + nugget*delta_jk, r_k(x) = R(x,x_k), and m is
+ *	the generalized least squares estimate of the mean. The variance of the
+ *	prediction (the uncertainty of the model at x) is
+ *
+ *	   s^2(x) = sigma^2*(1 + nugget - r(x)*R^{-1}*r(x))
+ *
+ *	where sigma^2 is the maximum likelihood estimate of the process
+ *	variance (Jones, D.R., M. Schonlau, W.J. Welch. "Efficient Global
+ *	Optimization of Expensive Black-Box Functions." J. Global Optim. Vol.
+ *	13, pp. 455-492, 1998). The variance vanishes at the samples (up to the
+ *	nugget), and grows away from them.
+ *
+ *	The Cholesky factor, L, of R is updated incrementally: adding a sample
+ *	appends one row to L, computed by one triangular solve (O(m^2) for m
+ *	samples), instead of refactoring R (O(m^3)). The mean, alpha, and
+ *	sigma^2 are then recomputed by triangular solves (O(m^2)). A prediction
+ *	costs O(m*dim) for the mean, and O(m^2) for the variance. All storage is
+ *	allocated at construction; once capacity samples have been added, the
+ *	model is full, and further samples are ignored.
+ *
+ *	The length scale should be comparable to the distance over which the
+ *	cost varies appreciably; e.g. of order 1 for designs scaled to the unit
+ *	cube (as assumed by OptimizerPSO).
+ */
+template<class V>
+class SurrogateModel
+{
+public:
+
+	typedef V VectorType;
+
+	SurrogateModel(Size dim_, Size capacity_=500, Real length_=1.0, Real nugget_=1.0E-8):
+		dim(dim_), cap(capacity_), len(length_), nugget(nugget_), m(0),
+		xs(dim_, capacity_), fs(capacity_), L(capacity_, capacity_),
+		alpha(capacity_), u(capacity_), r(capacity_), w(capacity_),
+		mean0(0), sigma2(0), fbest(0)
+	{
+		ASSERT( cap > 0 );
+		ASSERT( len > 0 );
+		ASSERT( nugget > 0 );
+	}
+
+	//! Returns the number of samples
+	Size size() const {return m;}
+
+	//! Returns the maximum number of samples
+	Size capacity() const {return cap;}
+
+	//! Returns true if no more samples can be added
+	bool full() const {return m == cap;}
+
+	//! Sets the length scale (removes all samples)
+	void lengthScale(Real len_)
+	{
+		ASSERT( len_ > 0 );
+		len = len_;
+		clear();
+	}
+
+	//! Returns the length scale
+	Real lengthScale() const {return len;}
+
+	//! Removes all samples
+	void clear() {m = 0;}
+
+	//! Returns the lowest sampled cost
+	Real bestCost() const
+	{
+		ASSERT( m > 0 );
+		return fbest;
+	}
+
+	//! Adds the sample (x, fx)
+	/*!
+	 *	Returns false, and ignores the sample, if the model is full, or if x
+	 *	(nearly) duplicates a sample, such that R would not be positive
+	 *	definite.
+	 */
+	bool add(const VectorType& x, Real fx)
+	{
+		if(full()) return false;
+
+		// Append row m of L: solve L*l = r(x), then d = sqrt(1 + nugget - l*l)...
+
+		correlations(x);
+		forwardSubstitution(r, w);
+
+		Real d2 = 1.0 + nugget;
+		for(Index k=0; k<m; ++k)
+			d2 -= w(k)*w(k);
+
+		if(not (d2 > 0)) return false;
+
+		for(Index k=0; k<m; ++k)
+			L(m,k) = w(k);
+		L(m,m) = std::sqrt(d2);
+
+		for(Index i=0; i<dim; ++i)
+			xs(i,m) = x(i);
+		fs(m) = fx;
+
+		fbest = (m == 0) ? fx : numlib::min(fbest, fx);
+
+		++m;
+
+		// Update mean, weights, and process variance...
+
+		for(Index k=0; k<m; ++k)
+			w(k) = 1.0;
+		solve(w, u);            /* u = R^{-1}*1 */
+		solve(fs, alpha);       /* alpha = R^{-1}*f */
+
+		Real uf = 0.0, u1 = 0.0;
+		for(Index k=0; k<m; ++k)
+		{
+			uf += alpha(k);
+			u1 += u(k);
+		}
+		mean0 = uf/u1;
+
+		sigma2 = 0.0;
+		for(Index k=0; k<m; ++k)
+		{
+			alpha(k) -= mean0*u(k);  /* alpha = R^{-1}*(f - m) */
+			sigma2 += (fs(k) - mean0)*alpha(k);
+		}
+		sigma2 = numlib::max(sigma2/m, 0.0);
+
+		return true;
+	}
+
+	//! Returns the predicted cost at x
+	Real mean(const VectorType& x)
+	{
+		ASSERT( m > 0 );
+
+		correlations(x);
+
+		Real mu = mean0;
+		for(Index k=0; k<m; ++k)
+			mu += r(k)*alpha(k);
+
+		return mu;
+	}
+
+	//! Computes the predicted cost, mu, and its standard deviation, s, at x
+	void predict(const VectorType& x, Real& mu, Real& s)
+	{
+		mu = mean(x); /* sets r */
+
+		forwardSubstitution(r, w);
+
+		Real s2 = 1.0 + nugget;
+		for(Index k=0; k<m; ++k)
+			s2 -= w(k)*w(k);
+
+		s = std::sqrt(sigma2*numlib::max(s2, 0.0));
+	}
+
+	//! Returns the lower confidence bound mu - kappa*s at x
+	/*!
+	 *	Minimizing the lower bound (as an infill criterion) balances
+	 *	exploitation (low mu) and exploration (high s); kappa weights
+	 *	exploration.
+	 */
+	Real lowerBound(const VectorType& x, Real kappa)
+	{
+		Real mu, s;
+		predict(x, mu, s);
+		return mu - kappa*s;
+	}
+
+	//! Returns the expected improvement over the lowest sampled cost at x
+	/*!
+	 *	EI = (fbest - mu)*Phi(z) + s*phi(z), z = (fbest - mu)/s, where Phi
+	 *	and phi are the standard normal distribution and density; maximizing
+	 *	EI is the infill criterion of Jones et al.
+	 *
+	 *	Phi is computed with erfc, which C++98 does not provide in std; C++98
+	 *	builds use the C99 ::erfc of the C math library.
+	 */
+	Real expectedImprovement(const VectorType& x)
+	{
+		Real mu, s;
+		predict(x, mu, s);
+
+		const Real df = fbest - mu;
+
+		if(not (s > 0)) return numlib::max(df, 0.0);
+
+		const Real z = df/s;
+#if __cplusplus >= 201103L
+		const Real Phi = 0.5*std::erfc(-z/std::sqrt(2.0));
+#else
+		const Real Phi = 0.5*::erfc(-z/std::sqrt(2.0));
+#endif
+		const Real phi = std::exp(-0.5*z*z)/std::sqrt(8.0*std::atan(1.0));
+
+		return df*Phi + s*phi;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( SurrogateModel );
+
+	//! Number of design variables
+	Size dim;
+
+	//! Maximum number of samples
+	Size cap;
+
+	//! Length scale
+	Real len;
+
+	//! Regularization of the correlation matrix
+	Real nugget;
+
+	//! Number of samples
+	Size m;
+
+	//! Sampled designs (one column per sample) and costs
+	linalg::Matrix<Real> xs;
+	array::Array1D<Real> fs;
+
+	//! Cholesky factor of the correlation matrix (lower triangle)
+	linalg::Matrix<Real> L;
+
+	//! Weights, R^{-1}*1, correlations r(x), and work space
+	array::Array1D<Real> alpha, u, r, w;
+
+	//! Mean and process variance
+	Real mean0, sigma2;
+
+	//! Lowest sampled cost
+	Real fbest;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Sets r(k) = R(x, x_k)
+	void correlations(const VectorType& x)
+	{
+		const Real c = 0.5/(len*len);
+
+		for(Index k=0; k<m; ++k)
+		{
+			Real d2 = 0.0;
+			for(Index i=0; i<dim; ++i)
+			{
+				const Real di = x(i) - xs(i,k);
+				d2 += di*di;
+			}
+			r(k) = std::exp(-c*d2);
+		}
+	}
+
+	// Solves L*y = b (first m rows)
+	void forwardSubstitution(const array::Array1D<Real>& b, array::Array1D<Real>& y) const
+	{
+		for(Index j=0; j<m; ++j)
+		{
+			Real s = b(j);
+			for(Index k=0; k<j; ++k)
+				s -= L(j,k)*y(k);
+			y(j) = s/L(j,j);
+		}
+	}
+
+	// Solves L*L'*y = b (first m rows); b may alias y
+	void solve(const array::Array1D<Real>& b, array::Array1D<Real>& y) const
+	{
+		forwardSubstitution(b, y);
+
+		for(Index j=m; j-- > 0; )
+		{
+			Real s = y(j);
+			for(Index k=j+1; k<m; ++k)
+				s -= L(k,j)*y(k);
+			y(j) = s/L(j,j);
+		}
+	}
+
+};
+
+}}//::numlib::optimization
+
+#endif
@@ -0,0 +1,136 @@
+/*! \file SurrogateScreening.h
+ *  \brief SurrogateScreening class template definition
+ */
+
+#ifndef SURROGATE_SCREENING_H
+#define SURROGATE_SCREENING_H
+
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../base/parallel_tools.h"
+
+#include "SurrogateModel.h"
+
+namespace numlib{ namespace optimization{
+
+//! Cost function wrapper which screens designs with a surrogate model
+/*!
+ *	Every design x passed to this wrapper is first screened by a surrogate
+ *	model (see SurrogateModel) of the cost function f: if the lower
+ *	confidence bound, mu(x) - kappa*s(x), exceeds the lowest cost evaluated
+ *	so far, x is unlikely to improve on it, and the predicted cost mu(x) is
+ *	returned without evaluating f. Otherwise, f is evaluated, and the sample
+ *	is added to the model. The exploration weight kappa (see kappa) keeps
+ *	designs where the model is uncertain from being screened out.
+ *	Screening starts once the model holds a minimum number of samples (see
+ *	minSamples); until then every design is evaluated.
+ *
+ *	Since the wrapper has the same interface as f, it may be used as the
+ *	cost function template argument of any optimizer; e.g. to screen the
+ *	particles proposed by OptimizerPSO, or the line search points of
+ *	OptimizerCG. Note that the optimizer cannot distinguish predicted costs
+ *	from evaluated ones; e.g. a particle's personal best may be a screened
+ *	design (whose predicted cost is, however, no better than the lowest
+ *	evaluated cost). Gradients, f(x, grad), are forwarded to f.
+ *
+ *	The wrapper may be called concurrently (provided f may). The model is
+ *	guarded by a Mutex, which is not held while f is evaluated.
+ *
+ *	This object holds references to f and the model for the duration of its
+ *	life. The model may be shared between runs, or preloaded with samples.
+ */
+template<class F, class V>
+class SurrogateScreening
+{
+public:
+
+	typedef F FunctionType;
+	typedef V VectorType;
+	typedef SurrogateModel<V> Model;
+
+	SurrogateScreening(FunctionType& f_, Model& model_, Real kappa_=2.0, Size nmin_=10):
+		f(f_), model(model_), kap(kappa_), nmin(nmin_), neval(0), nscreen(0)
+	{}
+
+	//! Sets the exploration weight of the screening criterion
+	void kappa(Real kappa_) {kap = kappa_;}
+
+	//! Returns the exploration weight of the screening criterion
+	Real kappa() const {return kap;}
+
+	//! Sets the number of samples required before designs are screened
+	void minSamples(Size nmin_) {nmin = nmin_;}
+
+	//! Returns the cost at x (evaluated or predicted)
+	Real operator()(const VectorType& x)
+	{
+		{
+			ScopedLock lock(mutex);
+
+			if(model.size() >= nmin and model.size() > 0)
+			{
+				Real mu, s;
+				model.predict(x, mu, s);
+
+				if(mu - kap*s > model.bestCost())
+				{
+					++nscreen;
+					return mu;
+				}
+			}
+		}
+
+		const Real fx = f(x);
+
+		ScopedLock lock(mutex);
+
+		++neval;
+		model.add(x, fx);
+
+		return fx;
+	}
+
+	//! Computes the gradient at x (forwarded to f)
+	void operator()(const VectorType& x, VectorType& grad) {f(x, grad);}
+
+	//! Returns the number of evaluations of f
+	Size evaluations() const {return neval;}
+
+	//! Returns the number of screened designs (not evaluated)
+	Size screened() const {return nscreen;}
+
+	//! Resets evaluation and screening counts
+	void resetStatistics()
+	{
+		neval = 0;
+		nscreen = 0;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( SurrogateScreening );
+
+	//! Reference to cost function
+	FunctionType& f;
+
+	//! Reference to surrogate model
+	Model& model;
+
+	//! Exploration weight
+	Real kap;
+
+	//! Minimum number of samples for screening
+	Size nmin;
+
+	//! Statistics
+	Size neval, nscreen;
+
+	//! Guards the model and statistics
+	Mutex mutex;
+
+};
+
+}}//::numlib::optimization
+
+#endif
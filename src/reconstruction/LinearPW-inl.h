@@ -111,6 +111,46 @@ void LinearPW<GridType,VecFieldType>::operator()(const VecFieldType & srcField,
 
 }
 
+template<class GridType, class VecFieldType>
+void LinearPW<GridType,VecFieldType>::transpose(const VecFieldType & dstField,
+												VecFieldType & srcField)
+{
+
+	 ASSERT( srcField.size() == nsrc);
+	 ASSERT( dstField.size() == ndst);
+
+	 for(Index i=0; i<nsrc; ++i)
+		  srcField(i) = 0;
+
+	 // Transpose of extrapolation over interval unbounded to the left...
+
+	 for(Index j=0; j<p(0); ++j)
+	 {
+		  srcField(0) += basisL(j)*dstField(j);
+		  srcField(1) += basisR(j)*dstField(j);
+	 }
+
+	 // Transpose of interpolation over bounded intervals...
+
+	 for(Index i=0; i<nsrc-1; ++i)
+	 {
+		  for(Index j=p(i); j<p(i+1); ++j)
+		  {
+			   srcField(i) += basisL(j)*dstField(j);
+			   srcField(i+1) += basisR(j)*dstField(j);
+		  }
+	 }
+
+	 // Transpose of extrapolation over interval unbounded to the right...
+
+	 for(Index j=p(nsrc-1); j<ndst; ++j)
+	 {
+		  srcField(nsrc-2) += basisL(j)*dstField(j);
+		  srcField(nsrc-1) += basisR(j)*dstField(j);
+	 }
+
+}
+
 template<class GridType, class VecFieldType> inline
 void LinearPW<GridType, VecFieldType>::copy(const LinearPW & other)
 {
@@ -39,6 +39,16 @@ public:
 	 LinearPW & operator=(const LinearPW & other);
 
 	 void operator()(const VecFieldType & srcField, VecFieldType & dstField);
+
+	 //! Applies the transpose of the interpolation operator
+	 /*!
+	  *  Accumulates each destination value into the source points from which
+	  *  it would be interpolated, weighted by the same basis functions; i.e.
+	  *  srcField = P'*dstField, where dstField = P*srcField is interpolation.
+	  *  This is the (unscaled) restriction operator associated with linear
+	  *  prolongation in multigrid methods.
+	  */
+	 void transpose(const VecFieldType & dstField, VecFieldType & srcField);
   
 private:
 
@@ -0,0 +1,483 @@
+/*! \file AdditiveSchwarz.h
+ */
+
+#ifndef ADDITIVE_SCHWARZ_H
+#define ADDITIVE_SCHWARZ_H
+
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../array/Array1D.h"
+#include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
+#include "../linalg/SquareMatrix.h"
+#include "../linalg/SparseMatrix.h"
+#include "../linalg/SparseMatrixExpressions.h"
+#include "GMRES.h"
+
+namespace numlib{ namespace solver{
+
+//! Schwarz preconditioner variants
+enum SchwarzVariant
+{
+	ADDITIVE,           /* overlap weighted by a partition of unity */
+	RESTRICTED_ADDITIVE /* each unknown is taken from its owning block only */
+};
+
+//! Subdomain (local) solver types
+enum SchwarzSolver
+{
+	DENSE_LU,    /* LU factorization with partial pivoting */
+	SPARSE_ILU0, /* incomplete LU factorization with zero fill-in */
+	KRYLOV_GMRES /* one (unpreconditioned) GMRES cycle */
+};
+
+//! Overlapping additive Schwarz preconditioner for sparse (CSR) matrices
+/*!
+ *  The unknowns are split into nb contiguous blocks (as for getPartition),
+ *  and each block is extended by the given overlap on either side; i.e.
+ *  block b owns unknowns [b*n/nb, (b+1)*n/nb), and contains the unknowns
+ *  within the overlap of its owned range. The preconditioner is
+ *
+ *     M^{-1} = sum_b R_b^T*D_b*A_b^{-1}*R_b
+ *
+ *  where R_b restricts a vector to block b, A_b = R_b*A*R_b^T is the
+ *  subdomain matrix, and D_b is a diagonal weight; the weights form a
+ *  partition of unity (sum_b R_b^T*D_b*R_b = I). For the ADDITIVE variant,
+ *  each unknown is weighted by the reciprocal of the number of blocks which
+ *  contain it. For the RESTRICTED_ADDITIVE variant (RAS), each unknown is
+ *  weighted by one in its owning block, and zero otherwise; this is
+ *  generally the more effective of the two (Cai, X.-C., and M. Sarkis. "A
+ *  Restricted Additive Schwarz Preconditioner for General Sparse Linear
+ *  Systems." SIAM J. Sci. Comput. Vol. 21, No. 2, pp. 792-797, 1999).
+ *
+ *  The subdomain problems are independent, and are solved concurrently
+ *  (one block per thread, scheduled dynamically since the local solvers may
+ *  differ in cost). The local solver is chosen per block; dense LU is
+ *  appropriate for small blocks, ILU(0) for large sparse blocks, and a
+ *  GMRES cycle for blocks which are poorly approximated by ILU(0). Note
+ *  that a GMRES local solve is a nonlinear function of its right hand side;
+ *  unless it is converged tightly (see localKrylov), the preconditioner then
+ *  varies between applications, which the (non-flexible) Krylov solvers do
+ *  not account for.
+ *
+ *  The matrix is referenced, not copied. If its values change (e.g. a new
+ *  Newton iteration) the local solvers must be refactored (see factor); the
+ *  sparsity pattern must not change.
+ *
+ *  This implements the preconditioner interface, apply(r, z); see
+ *  PreconditionedOperator.
+ */
+template<class T>
+class AdditiveSchwarz
+{
+public:
+
+	typedef linalg::Vector<T> VecType;
+
+	typedef linalg::SparseMatrix<T> MatType;
+
+	//! Partitions and factors A
+	/*!
+	 *  Arguments:
+	 *    a: square sparse matrix
+	 *    nb: number of blocks (subdomains)
+	 *    overlap: number of unknowns added on either side of each block
+	 *    variant: combination of the subdomain solutions
+	 *    solver: local solver used for every block (see localSolver)
+	 */
+	AdditiveSchwarz(const MatType & a_, Size nb_, Size overlap_,
+		SchwarzVariant variant_=RESTRICTED_ADDITIVE, SchwarzSolver solver=SPARSE_ILU0):
+		a(a_), n(a_.size1()), nb(nb_), nover(overlap_), blocks(0),
+		var(variant_), kdim(30), ktol(1.0e-8)
+	{
+		ASSERT( a.size1() == a.size2() );
+		ASSERT( nb > 0 );
+		ASSERT( nb <= n );
+
+		blocks = new Block[nb];
+		for(Index b=0; b<nb; ++b)
+		{
+			Block & blk = blocks[b];
+			blk.own0 = (b*n)/nb;
+			blk.own1 = ((b+1)*n)/nb;
+			blk.first = (blk.own0 > nover) ? blk.own0 - nover : 0;
+			blk.last = min(blk.own1 + nover, n);
+			blk.solver = solver;
+		}
+
+		initWeights();
+		factor();
+	}
+
+	~AdditiveSchwarz()
+	{
+		delete[] blocks;
+	}
+
+	//! Sets the local solver of block b; the block is refactored
+	void localSolver(Index b, SchwarzSolver solver)
+	{
+		ASSERT( b < nb );
+		blocks[b].solver = solver;
+		factorBlock(blocks[b]);
+	}
+
+	//! Returns the local solver of block b
+	SchwarzSolver localSolver(Index b) const { ASSERT( b < nb ); return blocks[b].solver; }
+
+	//! Sets maximum Krylov subspace dimension and relative tolerance of GMRES local solvers
+	void localKrylov(Size mmax, Real tol)
+	{
+		ASSERT( mmax > 0 );
+		kdim = mmax;
+		ktol = tol;
+		for(Index b=0; b<nb; ++b)
+			if(blocks[b].solver == KRYLOV_GMRES) factorBlock(blocks[b]);
+	}
+
+	//! Sets variant
+	void variant(SchwarzVariant v)
+	{
+		var = v;
+		initWeights();
+	}
+
+	//! Returns variant
+	SchwarzVariant variant() const { return var; }
+
+	//! Returns the number of blocks
+	Size numBlocks() const { return nb; }
+
+	//! Returns the overlap
+	Size overlap() const { return nover; }
+
+	//! Returns the first unknown of block b (including overlap)
+	Index blockBegin(Index b) const { ASSERT( b < nb ); return blocks[b].first; }
+
+	//! Returns the last unknown of block b plus 1 (including overlap)
+	Index blockEnd(Index b) const { ASSERT( b < nb ); return blocks[b].last; }
+
+	//! Extracts the subdomain matrices from A, and factors them
+	void factor()
+	{
+		#pragma omp parallel for schedule(dynamic)
+		for(Index b=0; b<nb; ++b)
+			factorBlock(blocks[b]);
+	}
+
+	//! Computes z = M^{-1}*r
+	void apply(const VecType & r, VecType & z)
+	{
+		ASSERT( r.size() == n );
+		ASSERT( &r != &z );
+
+		#pragma omp parallel for schedule(dynamic)
+		for(Index b=0; b<nb; ++b)
+		{
+			Block & blk = blocks[b];
+			linalg::getPartition(r, blk.r, blk.first, blk.last);
+			solveBlock(blk);
+		}
+
+		if(z.size() != n) z.resize(n);
+		z.zero();
+
+		for(Index b=0; b<nb; ++b)
+		{
+			const Block & blk = blocks[b];
+			for(Index q=0; q<blk.z.size(); ++q)
+				z(blk.first + q) += blk.w(q)*blk.z(q);
+		}
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( AdditiveSchwarz );
+
+	typedef array::Array1D<Index> IndexArray;
+
+	typedef GMRES<T,MatType> KrylovType;
+
+	//! Subdomain data
+	struct Block
+	{
+		Index first, last;     /* unknowns in block, [first, last) */
+		Index own0, own1;      /* owned unknowns, [own0, own1) */
+		SchwarzSolver solver;  /* local solver */
+		MatType a;             /* subdomain matrix */
+		MatType ilu;           /* ILU(0) factors */
+		IndexArray diag;       /* position of diagonal in ilu */
+		linalg::SquareMatrix<T> lu; /* dense LU factors */
+		IndexArray piv;        /* pivot row of each column of lu */
+		KrylovType* krylov;    /* GMRES solver */
+		VecType kr;            /* GMRES residual work vector */
+		VecType r, z, w;       /* local residual, solution, and weights */
+
+		Block(): krylov(0) {}
+
+		~Block() { delete krylov; }
+
+	private:
+
+		DISALLOW_COPY_AND_ASSIGN( Block );
+	};
+
+	//! Global matrix
+	const MatType & a;
+
+	//! Number of unknowns
+	Size n;
+
+	//! Number of blocks
+	Size nb;
+
+	//! Overlap
+	Size nover;
+
+	//! Blocks
+	Block* blocks;
+
+	//! Variant
+	SchwarzVariant var;
+
+	//! Maximum Krylov subspace dimension of GMRES local solvers
+	Size kdim;
+
+	//! Relative tolerance of GMRES local solvers
+	Real ktol;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Sets the partition of unity weights of each block
+	void initWeights()
+	{
+		IndexArray count(n);
+		for(Index i=0; i<n; ++i) count(i) = 0;
+		for(Index b=0; b<nb; ++b)
+			for(Index i=blocks[b].first; i<blocks[b].last; ++i)
+				++count(i);
+
+		for(Index b=0; b<nb; ++b)
+		{
+			Block & blk = blocks[b];
+			blk.w.resize(blk.last - blk.first);
+			for(Index i=blk.first; i<blk.last; ++i)
+			{
+				if(var == ADDITIVE)
+					blk.w(i - blk.first) = T(1)/T(count(i));
+				else
+					blk.w(i - blk.first) = ( (i >= blk.own0) and (i < blk.own1) ) ? T(1) : T(0);
+			}
+		}
+	}
+
+	// Extracts the subdomain matrix, and sets up the local solver
+	void factorBlock(Block & blk)
+	{
+		const Size m = blk.last - blk.first;
+
+		// Subdomain pattern...
+
+		IndexArray rowPtr(m+1);
+		rowPtr(0) = 0;
+		for(Index i=blk.first; i<blk.last; ++i)
+		{
+			Size cnt = 0;
+			for(Index k=a.rowBegin(i); k<a.rowEnd(i); ++k)
+				if( (a.column(k) >= blk.first) and (a.column(k) < blk.last) ) ++cnt;
+			rowPtr(i - blk.first + 1) = rowPtr(i - blk.first) + cnt;
+		}
+
+		IndexArray colIdx(rowPtr(m));
+		Index kk = 0;
+		for(Index i=blk.first; i<blk.last; ++i)
+			for(Index k=a.rowBegin(i); k<a.rowEnd(i); ++k)
+				if( (a.column(k) >= blk.first) and (a.column(k) < blk.last) )
+					colIdx(kk++) = a.column(k) - blk.first;
+
+		if( (blk.a.size1() != m) or (blk.a.nnz() != rowPtr(m)) )
+			blk.a.setPattern(m, m, rowPtr, colIdx);
+
+		// Subdomain values...
+
+		kk = 0;
+		for(Index i=blk.first; i<blk.last; ++i)
+			for(Index k=a.rowBegin(i); k<a.rowEnd(i); ++k)
+				if( (a.column(k) >= blk.first) and (a.column(k) < blk.last) )
+					blk.a.value(kk++) = a.value(k);
+
+		blk.r.resize(m);
+		blk.z.resize(m);
+
+		// Local solver...
+
+		delete blk.krylov;
+		blk.krylov = 0;
+
+		if(blk.solver == DENSE_LU)
+			factorLU(blk);
+		else if(blk.solver == SPARSE_ILU0)
+			factorILU0(blk);
+		else
+		{
+			blk.krylov = new KrylovType(m, min(kdim, m));
+			blk.kr.resize(m);
+		}
+	}
+
+	// Solves the subdomain problem, A_b*z = r
+	void solveBlock(Block & blk)
+	{
+		if(blk.solver == DENSE_LU)
+		{
+			solveLU(blk);
+		}
+		else if(blk.solver == SPARSE_ILU0)
+		{
+			solveILU0(blk);
+		}
+		else
+		{
+			blk.z.zero();
+			blk.krylov->solve(blk.a, blk.z, blk.r, ktol*norm2(blk.r), blk.kr);
+		}
+	}
+
+	// Dense LU factorization with partial pivoting (Doolittle, in-place)
+	void factorLU(Block & blk)
+	{
+		const Size m = blk.a.size1();
+		linalg::SquareMatrix<T> & lu = blk.lu;
+
+		if(lu.size() != m) lu = linalg::SquareMatrix<T>(m);
+		blk.piv.resize(m);
+
+		for(Index i=0; i<m; ++i)
+		{
+			for(Index j=0; j<m; ++j)
+				lu(i,j) = T(0);
+			for(Index k=blk.a.rowBegin(i); k<blk.a.rowEnd(i); ++k)
+				lu(i, blk.a.column(k)) = blk.a.value(k);
+		}
+
+		for(Index k=0; k<m; ++k)
+		{
+			Index p = k;
+			for(Index i=k+1; i<m; ++i)
+				if( abs(lu(i,k)) > abs(lu(p,k)) ) p = i;
+			blk.piv(k) = p;
+
+			ASSERT( lu(p,k) != T(0) );
+
+			if(p != k)
+				for(Index j=0; j<m; ++j)
+				{
+					T tmp = lu(k,j);
+					lu(k,j) = lu(p,j);
+					lu(p,j) = tmp;
+				}
+
+			for(Index i=k+1; i<m; ++i)
+			{
+				lu(i,k) /= lu(k,k);
+				for(Index j=k+1; j<m; ++j)
+					lu(i,j) -= lu(i,k)*lu(k,j);
+			}
+		}
+	}
+
+	void solveLU(Block & blk)
+	{
+		const Size m = blk.r.size();
+		const linalg::SquareMatrix<T> & lu = blk.lu;
+		VecType & z = blk.z;
+
+		z = blk.r;
+		for(Index k=0; k<m; ++k)
+		{
+			const Index p = blk.piv(k);
+			if(p != k)
+			{
+				T tmp = z(k);
+				z(k) = z(p);
+				z(p) = tmp;
+			}
+		}
+
+		for(Index i=1; i<m; ++i)
+			for(Index j=0; j<i; ++j)
+				z(i) -= lu(i,j)*z(j);
+
+		for(Index i=m; i-- > 0; )
+		{
+			for(Index j=i+1; j<m; ++j)
+				z(i) -= lu(i,j)*z(j);
+			z(i) /= lu(i,i);
+		}
+	}
+
+	// Incomplete LU factorization with zero fill-in (IKJ variant)
+	void factorILU0(Block & blk)
+	{
+		const Size m = blk.a.size1();
+		MatType & f = blk.ilu;
+
+		f = blk.a;
+		blk.diag.resize(m);
+
+		for(Index i=0; i<m; ++i)
+		{
+			blk.diag(i) = f.find(i,i);
+			ASSERT( blk.diag(i) < f.nnz() );
+		}
+
+		for(Index i=1; i<m; ++i)
+		{
+			for(Index k=f.rowBegin(i); k<f.rowEnd(i); ++k)
+			{
+				const Index c = f.column(k);
+				if(c >= i) break;
+
+				ASSERT( f.value(blk.diag(c)) != T(0) );
+				f.value(k) /= f.value(blk.diag(c));
+
+				for(Index kj=k+1; kj<f.rowEnd(i); ++kj)
+				{
+					const Index kc = f.find(c, f.column(kj));
+					if(kc < f.nnz())
+						f.value(kj) -= f.value(k)*f.value(kc);
+				}
+			}
+		}
+	}
+
+	void solveILU0(Block & blk)
+	{
+		const Size m = blk.r.size();
+		const MatType & f = blk.ilu;
+		VecType & z = blk.z;
+
+		for(Index i=0; i<m; ++i)
+		{
+			T zi = blk.r(i);
+			for(Index k=f.rowBegin(i); k<blk.diag(i); ++k)
+				zi -= f.value(k)*z(f.column(k));
+			z(i) = zi;
+		}
+
+		for(Index i=m; i-- > 0; )
+		{
+			T zi = z(i);
+			for(Index k=blk.diag(i)+1; k<f.rowEnd(i); ++k)
+				zi -= f.value(k)*z(f.column(k));
+			z(i) = zi/f.value(blk.diag(i));
+		}
+	}
+
+};
+
+}}//::numlib::solver
+
+#endif
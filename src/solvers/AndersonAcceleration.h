@@ -0,0 +1,361 @@
+/*! \file AndersonAcceleration.h
+ */
+
+#ifndef ANDERSON_ACCELERATION_H
+#define ANDERSON_ACCELERATION_H
+
+#include <cmath>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
+#include "../linalg/SquareMatrix.h"
+
+namespace numlib{ namespace solver{
+
+//! Anderson accelerated fixed point solver for nonlinear systems
+/*!
+ *  Solves f(u) = 0 by accelerating the (damped) fixed point iteration
+ *
+ *     u_{k+1} = g(u_k) = u_k + beta*f(u_k)
+ *
+ *  using Anderson mixing (Walker, H.F., and P. Ni. "Anderson Acceleration
+ *  for Fixed-Point Iterations." SIAM J. Numer. Anal. Vol. 49, No. 4,
+ *  pp. 1715-1735, 2011). The differences between the last m iterates, and
+ *  between their residuals, are retained, and each new iterate is taken to
+ *  be the combination of the retained iterates which minimizes the
+ *  linearized residual in the least squares sense. This requires only one
+ *  evaluation of f per iteration; in contrast, each NewtonKrylov iteration
+ *  requires one evaluation per Krylov vector (via GateauxFD).
+ *
+ *  The nonlinear operator, f, implements the same interface as for
+ *  NewtonKrylov; i.e. f.eval(u, r), where u is the approximate solution and
+ *  r is the (returned) residual vector. Likewise, this solver implements the
+ *  newSequence/iter interface of NewtonKrylov, and may be used in its place.
+ *  Note that the sign convention of f matters: the plain iteration above must
+ *  be (at least weakly) contractive for the chosen beta; e.g. for problems
+ *  written as f(u) = G(u) - u, beta = 1 recovers the fixed point map G.
+ *
+ *  The least squares problem is regularized (Tikhonov), with the penalty
+ *  scaled by the largest diagonal entry of the normal equations. The
+ *  history is discarded (restart) whenever the regularized normal equations
+ *  are numerically singular, in which case the iteration takes a plain
+ *  (damped) fixed point step. If an accelerated step grows the residual
+ *  norm by more than the restart ratio, the step is rejected: the history
+ *  is discarded and a plain (damped) fixed point step is taken from the
+ *  previous iterate instead (at the cost of a second evaluation of f).
+ *
+ *  Template arguments:
+ *  T.... Numeric type (e.g. numlib::Real)
+ *  NL... Nonlinear operator type
+ */
+template<class T, class NL>
+class AndersonAcceleration
+{
+public:
+
+	typedef linalg::Vector<T> VecType;
+
+	//! Initializes solver
+	/*!
+	 *  Arguments:
+	 *    n: rank of nonlinear operator
+	 *    m: window size (maximum number of retained differences)
+	 *    beta: mixing (damping) parameter of the fixed point map
+	 */
+	AndersonAcceleration(Size n_, Size m_, Real beta_=1.0):
+		n(n_), m(m_), mk(0), head(0), beta(beta_), reg(1.0E-10),
+		restart_ratio(1.0E2), rn(0), r(n_), u_old(n_), r_old(n_),
+		dU(0), dF(0), gram(m_), a(m_), gamma(m_)
+	{
+		ASSERT( m > 0 );
+
+		dU = new VecType[m];
+		dF = new VecType[m];
+		for(Index j=0; j<m; ++j)
+		{
+			dU[j].resize(n);
+			dF[j].resize(n);
+		}
+	}
+
+	~AndersonAcceleration()
+	{
+		delete[] dU;
+		delete[] dF;
+	}
+
+	//! Sets mixing (damping) parameter
+	void mixing(Real beta_) { beta = beta_; }
+
+	//! Returns mixing (damping) parameter
+	Real mixing() const { return beta; }
+
+	//! Sets relative Tikhonov regularization of the least squares problem
+	void regularization(Real reg_) { reg = reg_; }
+
+	//! Returns relative Tikhonov regularization of the least squares problem
+	Real regularization() const { return reg; }
+
+	//! Sets residual growth ratio which triggers a restart
+	void restartRatio(Real ratio) { restart_ratio = ratio; }
+
+	//! Returns residual growth ratio which triggers a restart
+	Real restartRatio() const { return restart_ratio; }
+
+	//! Returns window size
+	Size window() const { return m; }
+
+	//! Returns the number of differences currently retained
+	Size historySize() const { return mk; }
+
+	//! Discards the retained history
+	void restart() { mk = 0; }
+
+	//! Initialize a new non-linear iteration sequence
+	/*!
+	 *  The residual 2-norm of the nonlinear system, f(u), is returned
+	 */
+	T newSequence(NL & f, const VecType & u0)
+	{
+		restart();
+
+		DEBUG_PRINT( "Computing initial residual" );
+
+		f.eval(u0, r);
+		rn = norm2(r);
+
+		DEBUG_PRINT_VAR( rn );
+
+		return rn;
+	}
+
+	//! Executes a single non-linear iteration
+	/*!
+	 *  Upon input, u is expected to contain the previous (initial)
+	 *  solution estimate. Upon return, u is overwritten with the corrected
+	 *  solution estimate. The residual 2-norm of the nonlinear system, f(u),
+	 *  is returned as rvalue.
+	 */
+	T iter(NL & f, VecType & u)
+	{
+		ASSERT( u.size() == n );
+
+		// Retain current iterate for computing differences...
+
+		u_old = u;
+		r_old = r;
+		const T rn_old = rn;
+
+		// Compute mixing coefficients (gamma)...
+
+		if( (mk > 0) and !mixingCoefficients() )
+		{
+			DEBUG_PRINT( "Singular least squares problem; restarting" );
+			restart();
+		}
+
+		// Compute new iterate...
+		// -- u = u + beta*r - sum_j gamma_j*(dU_j + beta*dF_j)
+
+		for(Index i=0; i<n; ++i)
+			u(i) += beta*r(i);
+
+		for(Index j=0; j<mk; ++j)
+		{
+			const VecType& dUj = dU[slot(j)];
+			const VecType& dFj = dF[slot(j)];
+			const T gj = gamma(j);
+			for(Index i=0; i<n; ++i)
+				u(i) -= gj*(dUj(i) + beta*dFj(i));
+		}
+
+		// Update nonlinear residual...
+
+		f.eval(u, r); /* r = f(u) */
+		rn = norm2(r);
+
+		DEBUG_PRINT_VAR( rn );
+
+		// Safeguard against divergence...
+		// -- Reject the accelerated step, and take a plain (damped) step
+		//    from the previous iterate instead.
+
+		if( (mk > 0) and (rn > restart_ratio*rn_old) )
+		{
+			DEBUG_PRINT( "Residual growth exceeded restart ratio; restarting" );
+			restart();
+
+			for(Index i=0; i<n; ++i)
+				u(i) = u_old(i) + beta*r_old(i);
+
+			f.eval(u, r);
+			rn = norm2(r);
+
+			DEBUG_PRINT_VAR( rn );
+		}
+
+		// Append newest differences to history...
+
+		appendHistory(u);
+
+		return rn;
+	}
+
+	//! Returns a reference to the internally held residual vector
+	/*!
+	 *  The life of the residual vector is guarenteed for the life
+	 *  of this solver.
+	 */
+	const VecType & residual() { return r; }
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( AndersonAcceleration );
+
+	//! Space dimension
+	Size n;
+
+	//! Window size
+	Size m;
+
+	//! Number of retained differences
+	Size mk;
+
+	//! History slot to be written next
+	Index head;
+
+	//! Mixing parameter
+	Real beta;
+
+	//! Relative regularization parameter
+	Real reg;
+
+	//! Residual growth which triggers a restart
+	Real restart_ratio;
+
+	//! Residual vector 2-norm
+	T rn;
+
+	//! Residual vector
+	VecType r;
+
+	//! Previous iterate and its residual
+	VecType u_old, r_old;
+
+	//! Circular buffers of iterate and residual differences
+	VecType* dU;
+	VecType* dF;
+
+	//! Inner products of residual differences, gram(i,j) = dF_i.dF_j (by slot)
+	linalg::SquareMatrix<T> gram;
+
+	//! Cholesky factor of the regularized normal equations
+	linalg::SquareMatrix<T> a;
+
+	//! Mixing coefficients
+	linalg::Vector<T> gamma;
+
+	// Maps jth oldest retained difference to its history slot
+	Index slot(Index j) const
+	{
+		return (head + m - mk + j) % m;
+	}
+
+	// Appends the differences between u and u_old (and r and r_old)
+	void appendHistory(const VecType& u)
+	{
+		const Index s = head;
+
+		VecType& dUs = dU[s];
+		VecType& dFs = dF[s];
+		for(Index i=0; i<n; ++i)
+		{
+			dUs(i) = u(i) - u_old(i);
+			dFs(i) = r(i) - r_old(i);
+		}
+
+		head = (head + 1) % m;
+		if(mk < m) ++mk;
+
+		// Update inner products with the retained differences...
+
+		for(Index j=0; j<mk; ++j)
+		{
+			const Index sj = slot(j);
+			const T g = prod(dFs, dF[sj]);
+			gram(s, sj) = g;
+			gram(sj, s) = g;
+		}
+	}
+
+	// Solves (dF'dF + mu*I)*gamma = dF'r by Cholesky factorization
+	/*!
+	 *  Returns false if the regularized system is numerically singular.
+	 */
+	bool mixingCoefficients()
+	{
+		// Assemble normal equations...
+
+		T dmax(0);
+		for(Index j=0; j<mk; ++j)
+			dmax = max(dmax, gram(slot(j), slot(j)));
+
+		if( !(dmax > 0) ) return false;
+
+		const T mu = reg*dmax;
+
+		for(Index j=0; j<mk; ++j)
+		{
+			for(Index i=0; i<mk; ++i)
+				a(i,j) = gram(slot(i), slot(j));
+			a(j,j) += mu;
+			gamma(j) = prod(dF[slot(j)], r);
+		}
+
+		// Factor (lower triangle, in-place)...
+
+		for(Index j=0; j<mk; ++j)
+		{
+			T d = a(j,j);
+			for(Index k=0; k<j; ++k)
+				d -= a(j,k)*a(j,k);
+			if( !(d > 1.0E-14*dmax) ) return false;
+			d = std::sqrt(d);
+			a(j,j) = d;
+			for(Index i=j+1; i<mk; ++i)
+			{
+				T v = a(i,j);
+				for(Index k=0; k<j; ++k)
+					v -= a(i,k)*a(j,k);
+				a(i,j) = v/d;
+			}
+		}
+
+		// Forward and backward substitution...
+
+		for(Index i=0; i<mk; ++i)
+		{
+			T v = gamma(i);
+			for(Index k=0; k<i; ++k)
+				v -= a(i,k)*gamma(k);
+			gamma(i) = v/a(i,i);
+		}
+
+		for(Index i=mk; i-- > 0; )
+		{
+			T v = gamma(i);
+			for(Index k=i+1; k<mk; ++k)
+				v -= a(k,i)*gamma(k);
+			gamma(i) = v/a(i,i);
+		}
+
+		return true;
+	}
+
+};
+
+}}//::numlib::solver
+
+#endif
@@ -0,0 +1,492 @@
+/*! \file BatchNewton.h
+ */
+
+#ifndef BATCH_NEWTON_H
+#define BATCH_NEWTON_H
+
+#include "../base/numlib-config.h"
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/parallel_tools.h"
+#include "../array/Array1D.h"
+#include "../linalg/Matrix.h"
+
+namespace numlib{ namespace solver{
+
+//! Newton solver for large ensembles of small independent nonlinear systems
+/*!
+ *  Solves f_s(u_s) = 0 for s = 0, ..., N-1, where each u_s is a vector of
+ *  (small) dimension n, and the systems are not coupled to one another
+ *  (e.g. per-cell chemistry or per-element constitutive updates). Solving
+ *  such systems one at a time with NewtonKrylov is dominated by overhead;
+ *  instead, this solver processes the systems in blocks, and every operation
+ *  within a block (residual evaluation, Jacobian formation, LU factorization)
+ *  is vectorized across the systems of the block.
+ *
+ *  All batch data is stored in a struct-of-arrays layout using a column
+ *  major Matrix, where row s holds system s and column j holds unknown j.
+ *  Thus, the jth unknown of every system in a block is contiguous in memory.
+ *  The Jacobians are formed by forward differences (n + 1 residual
+ *  evaluations of the block per Newton iteration), and solved using an LU
+ *  factorization with partial pivoting which operates on all systems of the
+ *  block simultaneously.
+ *
+ *  Systems which satisfy the convergence criteria drop out of their block;
+ *  i.e. the block is compacted so that subsequent iterations only operate on
+ *  the systems which are still active. Systems which encounter a singular
+ *  Jacobian also drop out, and are reported as unconverged.
+ *
+ *  Blocks are distributed across threads (when compiled with OpenMP). Each
+ *  thread owns its own work space, so the only requirement on the residual
+ *  operator is that eval may be called concurrently for disjoint sets of
+ *  systems.
+ *
+ *  The batch residual operator, f, must implement the interface
+ *
+ *     void eval(const Index* sys, Size m, const Matrix<T>& u, Matrix<T>& r)
+ *
+ *  where rows 0, ..., m-1 of u hold the current estimates of the systems
+ *  sys[0], ..., sys[m-1], and the corresponding rows of r are to be set to
+ *  the residuals of those systems. Rows m and beyond are work space and
+ *  should be ignored. Note, the system indices are not necessarily
+ *  contiguous (or ordered) since converged systems are removed from a block.
+ *
+ *  Template arguments:
+ *  T.... Numeric type (e.g. numlib::Real)
+ *  NL... Batch nonlinear operator type
+ */
+template<class T, class NL>
+class BatchNewton
+{
+public:
+
+	typedef linalg::Matrix<T> BatchType;
+
+	//! Initializes solver
+	/*!
+	 *  Arguments:
+	 *    n: rank of each nonlinear system
+	 *    block_size: number of systems processed together by one thread
+	 *    tol: stopping criteria on the residual 2-norm of each system
+	 *    max_iter: maximum number of Newton iterations per system
+	 */
+	BatchNewton(Size n_, Size block_size=64, Real tol_=1.0E-10, Size max_iter_=20):
+		n(n_), bs(block_size), tol(tol_), max_iter(max_iter_),
+		eps(std::sqrt(2.2E-16)), nwork(0), work(0), work_bs(0)
+	{
+		ASSERT( n > 0 );
+		ASSERT( bs > 0 );
+	}
+
+	~BatchNewton()
+	{
+		delete[] work;
+	}
+
+	//! Sets convergence tolerance
+	void tolerance(Real tol_) { tol = tol_; }
+
+	//! Returns convergence tolerance
+	Real tolerance() const { return tol; }
+
+	//! Sets maximum number of Newton iterations per system
+	void maxIteration(Size max_iter_) { max_iter = max_iter_; }
+
+	//! Returns maximum number of Newton iterations per system
+	Size maxIteration() const { return max_iter; }
+
+	//! Sets the number of systems processed together
+	void blockSize(Size block_size) { ASSERT( block_size > 0 ); bs = block_size; }
+
+	//! Returns the number of systems processed together
+	Size blockSize() const { return bs; }
+
+	//! Solves every system contained in the batch
+	/*!
+	 *  Upon input, row s of u contains the initial estimate for system s.
+	 *  Upon output, row s of u contains the final estimate for system s.
+	 *  The number of systems which failed to converge is returned; the
+	 *  status of individual systems may be queried using converged,
+	 *  iterations, and residualNorm.
+	 */
+	Size solve(NL& f, BatchType& u)
+	{
+		ASSERT( u.size2() == n );
+
+		const Size nsys = u.size1();
+		const Size nblk = (nsys + bs - 1)/bs;
+
+		// Allocate per-system status and per-thread work space...
+
+		if(status.size() != nsys)
+		{
+			status.resize(nsys);
+			iter_count.resize(nsys);
+			res_norm.resize(nsys);
+		}
+
+		allocateWork();
+
+		// Solve blocks of systems...
+
+		#pragma omp parallel for schedule(dynamic)
+		for(Index b=0; b<nblk; ++b)
+		{
+			const Index first = b*bs;
+			const Size m = min(bs, nsys - first);
+			solveBlock(f, u, first, m, work[threadIndex()]);
+		}
+
+		// Count failures...
+
+		Size nfail = 0;
+		for(Index s=0; s<nsys; ++s)
+			if(!status(s)) ++nfail;
+
+		DEBUG_PRINT_VAR( nfail );
+
+		return nfail;
+	}
+
+	//! Returns true if system s satisfied the convergence criteria
+	bool converged(Index s) const { return status(s); }
+
+	//! Returns the number of Newton iterations executed for system s
+	Size iterations(Index s) const { return iter_count(s); }
+
+	//! Returns the final residual 2-norm of system s
+	Real residualNorm(Index s) const { return res_norm(s); }
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( BatchNewton );
+
+/*----------------------------------------------------------------------------*/
+/*                                                Helper classes and typedefs */
+
+	//! Work space used by one thread to process one block
+	struct Workspace
+	{
+		BatchType u;            /* solution estimates */
+		BatchType r;            /* residuals */
+		BatchType rp;           /* perturbed residuals */
+		BatchType b;            /* right-hand-side/Newton correction */
+		BatchType J;            /* Jacobians; column i + j*n holds J(i,j) */
+		array::Array1D<Index> sys;   /* system indices */
+		array::Array1D<Index> piv;   /* pivot rows */
+		array::Array1D<T> h;         /* finite difference steps */
+		array::Array1D<T> w;         /* scratch */
+		array::Array1D<bool> singular;
+
+		void resize(Size n, Size bs)
+		{
+			u.resize(bs, n);
+			r.resize(bs, n);
+			rp.resize(bs, n);
+			b.resize(bs, n);
+			J.resize(bs, n*n);
+			sys.resize(bs);
+			piv.resize(bs);
+			h.resize(bs);
+			w.resize(bs);
+			singular.resize(bs);
+		}
+	};
+
+/*----------------------------------------------------------------------------*/
+/*                                                                Member data */
+
+	Size n;             /* rank of each system */
+	Size bs;            /* block size */
+	Real tol;
+	Size max_iter;
+	Real eps;           /* relative finite difference step */
+
+	array::Array1D<bool> status;
+	array::Array1D<Size> iter_count;
+	array::Array1D<Real> res_norm;
+
+	Size nwork;
+	Workspace* work;
+	Size work_bs;
+
+/*----------------------------------------------------------------------------*/
+/*                                                           Helper functions */
+
+	// Ensures each thread has a work space sized for the current block size
+	void allocateWork()
+	{
+		const Size nthreads = maxThreads();
+		if( (nwork != nthreads) or (work_bs != bs) )
+		{
+			delete[] work;
+			nwork = nthreads;
+			work_bs = bs;
+			work = new Workspace[nwork];
+			for(Index k=0; k<nwork; ++k)
+				work[k].resize(n, bs);
+		}
+	}
+
+	// Executes Newton iterations on systems first, ..., first + m - 1
+	void solveBlock(NL& f, BatchType& U, Index first, Size m, Workspace& ws)
+	{
+		// Gather block (one contiguous column segment per unknown)...
+
+		for(Index s=0; s<m; ++s)
+		{
+			ws.sys(s) = first + s;
+			ws.singular(s) = false;
+		}
+
+		for(Index j=0; j<n; ++j)
+		{
+			const T* src = &U(first, j);
+			T* dst = &ws.u(0, j);
+			for(Index s=0; s<m; ++s)
+				dst[s] = src[s];
+		}
+
+		f.eval(&ws.sys(0), m, ws.u, ws.r);
+
+		for(Index k=0; ; ++k)
+		{
+			// Compute residual norms...
+
+			T* rn = &ws.w(0);
+			for(Index s=0; s<m; ++s)
+				rn[s] = 0.0;
+			for(Index j=0; j<n; ++j)
+			{
+				const T* r = &ws.r(0, j);
+				for(Index s=0; s<m; ++s)
+					rn[s] += r[s]*r[s];
+			}
+
+			// Retire converged (or failed) systems...
+
+			Index s = 0;
+			while(s < m)
+			{
+				const T rns = std::sqrt(rn[s]);
+				const bool done = rns < tol;
+				if( done or ws.singular(s) or (k == max_iter) )
+				{
+					retire(U, ws, s, m, k, rns, done and !ws.singular(s));
+					rn[s] = rn[m-1];
+					--m;
+				}
+				else
+				{
+					++s;
+				}
+			}
+
+			if(m == 0) return;
+
+			// Compute Newton correction...
+
+			jacobian(f, ws, m);
+
+			for(Index j=0; j<n; ++j)
+			{
+				const T* r = &ws.r(0, j);
+				T* b = &ws.b(0, j);
+				for(Index s=0; s<m; ++s)
+					b[s] = -r[s];
+			}
+
+			factorAndSolve(ws, m);
+
+			// Apply correction and update residuals...
+
+			for(Index j=0; j<n; ++j)
+			{
+				const T* b = &ws.b(0, j);
+				T* u = &ws.u(0, j);
+				for(Index s=0; s<m; ++s)
+					u[s] += b[s];
+			}
+
+			f.eval(&ws.sys(0), m, ws.u, ws.r);
+		}
+	}
+
+	// Records the result of row s, then replaces it with the last active row
+	void retire(BatchType& U, Workspace& ws, Index s, Size m, Size k, T rns, bool ok)
+	{
+		const Index id = ws.sys(s);
+
+		status(id) = ok;
+		iter_count(id) = k;
+		res_norm(id) = rns;
+
+		for(Index j=0; j<n; ++j)
+			U(id, j) = ws.u(s, j);
+
+		// Compact block...
+
+		const Index last = m - 1;
+		if(s != last)
+		{
+			for(Index j=0; j<n; ++j)
+			{
+				ws.u(s, j) = ws.u(last, j);
+				ws.r(s, j) = ws.r(last, j);
+			}
+			ws.sys(s) = ws.sys(last);
+			ws.singular(s) = ws.singular(last);
+		}
+	}
+
+	// Forms the Jacobians of the active systems using forward differences
+	void jacobian(NL& f, Workspace& ws, Size m)
+	{
+		T* h = &ws.h(0);
+		T* usave = &ws.w(0);
+
+		for(Index j=0; j<n; ++j)
+		{
+			// Perturb unknown j of every system...
+
+			T* u = &ws.u(0, j);
+			for(Index s=0; s<m; ++s)
+			{
+				usave[s] = u[s];
+				const T hs = eps*max(T(std::fabs(u[s])), T(1.0));
+				u[s] += hs;
+				h[s] = u[s] - usave[s]; /* exactly representable step */
+			}
+
+			f.eval(&ws.sys(0), m, ws.u, ws.rp);
+
+			for(Index s=0; s<m; ++s)
+				u[s] = usave[s];
+
+			// Store column j of each Jacobian...
+
+			for(Index i=0; i<n; ++i)
+			{
+				const T* rp = &ws.rp(0, i);
+				const T* r = &ws.r(0, i);
+				T* Jij = &ws.J(0, i + j*n);
+				for(Index s=0; s<m; ++s)
+					Jij[s] = (rp[s] - r[s])/h[s];
+			}
+		}
+	}
+
+	// Solves J*x = b in-place (x overwrites b) for every active system
+	/*!
+	 *  Gaussian elimination with partial pivoting. Each loop over the systems
+	 *  is innermost, so the elimination vectorizes across the block. Row
+	 *  interchanges are the only per-system (gather) operations.
+	 */
+	void factorAndSolve(Workspace& ws, Size m)
+	{
+		T* amax = &ws.h(0);
+		T* l = &ws.w(0);
+		Index* p = &ws.piv(0);
+
+		for(Index k=0; k<n; ++k)
+		{
+			// Find pivot rows...
+
+			const T* Jkk = &ws.J(0, k + k*n);
+			for(Index s=0; s<m; ++s)
+			{
+				p[s] = k;
+				amax[s] = std::fabs(Jkk[s]);
+			}
+
+			for(Index i=k+1; i<n; ++i)
+			{
+				const T* Jik = &ws.J(0, i + k*n);
+				for(Index s=0; s<m; ++s)
+				{
+					const T a = std::fabs(Jik[s]);
+					if(a > amax[s])
+					{
+						amax[s] = a;
+						p[s] = i;
+					}
+				}
+			}
+
+			// Interchange rows...
+
+			for(Index s=0; s<m; ++s)
+			{
+				if(p[s] != k)
+				{
+					for(Index j=k; j<n; ++j)
+						std::swap(ws.J(s, k + j*n), ws.J(s, p[s] + j*n));
+					std::swap(ws.b(s, k), ws.b(s, p[s]));
+				}
+			}
+
+			// Flag singular systems (a unit pivot keeps the sweep finite)...
+
+			for(Index s=0; s<m; ++s)
+			{
+				if( !(amax[s] > 0.0) )
+				{
+					ws.singular(s) = true;
+					ws.J(s, k + k*n) = 1.0;
+				}
+			}
+
+			// Eliminate entries below the diagonal...
+
+			for(Index i=k+1; i<n; ++i)
+			{
+				const T* Jik = &ws.J(0, i + k*n);
+				for(Index s=0; s<m; ++s)
+					l[s] = Jik[s]/Jkk[s];
+
+				for(Index j=k+1; j<n; ++j)
+				{
+					const T* Jkj = &ws.J(0, k + j*n);
+					T* Jij = &ws.J(0, i + j*n);
+					for(Index s=0; s<m; ++s)
+						Jij[s] -= l[s]*Jkj[s];
+				}
+
+				const T* bk = &ws.b(0, k);
+				T* bi = &ws.b(0, i);
+				for(Index s=0; s<m; ++s)
+					bi[s] -= l[s]*bk[s];
+			}
+		}
+
+		// Back substitution...
+
+		for(Index k=n; k-- > 0; )
+		{
+			T* bk = &ws.b(0, k);
+			for(Index j=k+1; j<n; ++j)
+			{
+				const T* Jkj = &ws.J(0, k + j*n);
+				const T* bj = &ws.b(0, j);
+				for(Index s=0; s<m; ++s)
+					bk[s] -= Jkj[s]*bj[s];
+			}
+
+			const T* Jkk = &ws.J(0, k + k*n);
+			for(Index s=0; s<m; ++s)
+				bk[s] /= Jkk[s];
+		}
+
+		// Discard corrections of singular systems...
+
+		for(Index s=0; s<m; ++s)
+			if(ws.singular(s))
+				for(Index j=0; j<n; ++j)
+					ws.b(s, j) = 0.0;
+	}
+
+}; // class BatchNewton
+
+}}//::numlib::solver
+
+#endif
@@ -0,0 +1,411 @@
+/*! \file Continuation.h
+ */
+
+#ifndef CONTINUATION_H
+#define CONTINUATION_H
+
+#include <cmath>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
+#include "NewtonGMRES.h"
+
+namespace numlib{ namespace solver{
+
+//! Continuation strategies
+enum ContinuationMode
+{
+	NATURAL_PARAMETER, /* march in the parameter, lambda */
+	PSEUDO_ARCLENGTH   /* march in the arclength of the solution curve */
+};
+
+//! Parameterized nonlinear operator augmented with a continuation constraint
+/*!
+ *  For y = (u, lambda), of dimension n+1, evaluates
+ *
+ *     R(y) = [ F(u; lambda)     ]
+ *            [ c'(y - y_pred)   ]
+ *
+ *  where c is the constraint direction and y_pred the predicted point. With
+ *  c = (0,...,0,1) the parameter is fixed at its predicted value (natural
+ *  parameter continuation); with c equal to the unit tangent of the solution
+ *  curve the correction is orthogonal to the tangent (pseudo-arclength
+ *  continuation), which remains well posed at simple turning points.
+ *
+ *  This operator is used internally by Continuation.
+ */
+template<class T, class NL>
+class ArclengthOperator
+{
+public:
+
+	typedef linalg::Vector<T> VecType;
+
+	ArclengthOperator(Size n_):
+		f(0), n(n_), c(n_+1), ypred(n_+1), uwork(n_), rwork(n_)
+	{
+		c.zero();
+		c(n) = 1.0;
+		ypred.zero();
+	}
+
+	//! Sets the parameterized nonlinear operator, F(u; lambda)
+	void bind(NL & f_) { f = &f_; }
+
+	//! Returns the constraint direction
+	VecType & constraint() { return c; }
+
+	//! Returns the predicted point
+	VecType & predicted() { return ypred; }
+
+	//! Evaluates the augmented residual, r = R(y)
+	void eval(const VecType & y, VecType & r)
+	{
+		ASSERT( f != 0 );
+		ASSERT( y.size() == n+1 );
+		ASSERT( r.size() == n+1 );
+
+		for(Index i=0; i<n; ++i)
+			uwork(i) = y(i);
+
+		f->parameter(y(n));
+		f->eval(uwork, rwork);
+
+		T g(0);
+		for(Index i=0; i<n; ++i)
+		{
+			r(i) = rwork(i);
+			g += c(i)*(y(i) - ypred(i));
+		}
+		r(n) = g + c(n)*(y(n) - ypred(n));
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( ArclengthOperator );
+
+	//! Parameterized nonlinear operator
+	NL* f;
+
+	//! Rank of f
+	Size n;
+
+	//! Constraint direction
+	VecType c;
+
+	//! Predicted point
+	VecType ypred;
+
+	//! Work vectors for the evaluation of f
+	VecType uwork, rwork;
+
+};
+
+//! Continuation driver for parameterized nonlinear systems
+/*!
+ *  Traces the solution curve of F(u; lambda) = 0 as the parameter, lambda,
+ *  is varied. Each point on the curve is computed by a Newton-GMRES
+ *  correction started from a secant predictor (extrapolation from the two
+ *  previous points), so that typically only a few Newton iterations are
+ *  needed per point. The first step, for which only one point is known,
+ *  uses a zeroth order predictor.
+ *
+ *  Two strategies are supported (see ContinuationMode):
+ *
+ *  NATURAL_PARAMETER: lambda is advanced by the step size, ds, and u is
+ *  corrected with lambda held fixed. Fails at turning points (dlambda/ds = 0).
+ *
+ *  PSEUDO_ARCLENGTH: (u, lambda) is advanced a distance ds along the secant
+ *  of the solution curve, and corrected orthogonal to the secant (Keller,
+ *  H.B. "Numerical Solution of Bifurcation and Nonlinear Eigenvalue
+ *  Problems." Applications of Bifurcation Theory, Academic Press, pp.
+ *  359-384, 1977). Since lambda is solved for, the curve may be followed
+ *  around turning points; the direction of travel is carried by the secant.
+ *  The arclength is measured in the unweighted 2-norm of (u, lambda).
+ *
+ *  The step size is adapted after each point so that the corrector takes
+ *  about the target number of Newton iterations. If the corrector fails to
+ *  converge, the step size is halved and the step is retried, until the
+ *  step size falls below the minimum step size.
+ *
+ *  The nonlinear operator, f, implements the same interface as for
+ *  NewtonKrylov (i.e. f.eval(u, r)), and in addition the parameter setter
+ *  f.parameter(lambda), which is called before each evaluation.
+ *
+ *  Template arguments:
+ *  T.... Numeric type (e.g. numlib::Real)
+ *  NL... Parameterized nonlinear operator type
+ */
+template<class T, class NL>
+class Continuation
+{
+public:
+
+	typedef linalg::Vector<T> VecType;
+
+	typedef ArclengthOperator<T,NL> OpType;
+
+	//! Initializes driver
+	/*!
+	 *  Arguments:
+	 *    n: rank of nonlinear operator
+	 *    mmax: maximum Krylov subspace dimension of the corrector
+	 *    tol: convergence tolerance (2-norm of the residual) of the corrector
+	 *    mode: continuation strategy
+	 */
+	Continuation(Size n_, Size mmax_, Real tol_, ContinuationMode mode_=PSEUDO_ARCLENGTH):
+		n(n_), mode(mode_), tol(tol_), eta(1.0E-3), ds(0.1), ds_min(1.0E-8),
+		ds_max(1.0E8), max_iter(10), target_iter(3), last_iter(0), npoints(0),
+		op(n_), newton(n_+1, mmax_, 1, tol_), y(n_+1), y0(n_+1), y1(n_+1)
+	{ }
+
+	//! Sets the (signed) step size; the sign sets the initial direction in lambda
+	void stepSize(Real ds_) { ds = ds_; }
+
+	//! Returns the (signed) step size
+	Real stepSize() const { return ds; }
+
+	//! Sets bounds on the magnitude of the adapted step size
+	void stepSizeBounds(Real ds_min_, Real ds_max_)
+	{
+		ASSERT( ds_min_ > 0.0 );
+		ASSERT( ds_min_ <= ds_max_ );
+		ds_min = ds_min_;
+		ds_max = ds_max_;
+	}
+
+	//! Sets convergence tolerance of the corrector
+	void tolerance(Real tol_) { tol = tol_; }
+
+	//! Returns convergence tolerance of the corrector
+	Real tolerance() const { return tol; }
+
+	//! Sets maximum number of Newton iterations per corrector
+	void maxIterations(Size max_iter_) { max_iter = max_iter_; }
+
+	//! Returns maximum number of Newton iterations per corrector
+	Size maxIterations() const { return max_iter; }
+
+	//! Sets the desired number of Newton iterations per corrector
+	void targetIterations(Size target) { ASSERT( target > 0 ); target_iter = target; }
+
+	//! Returns the desired number of Newton iterations per corrector
+	Size targetIterations() const { return target_iter; }
+
+	//! Returns the number of Newton iterations used by the last corrector
+	Size iterations() const { return last_iter; }
+
+	//! Returns the continuation strategy
+	ContinuationMode continuationMode() const { return mode; }
+
+	//! Computes the first point on the solution curve
+	/*!
+	 *  Solves F(u; lambda0) = 0, starting from u. Upon return, u contains
+	 *  the solution. Returns true if the corrector converged.
+	 */
+	bool newSequence(NL & f, VecType & u, Real lambda0)
+	{
+		ASSERT( u.size() == n );
+
+		npoints = 0;
+
+		setPoint(y, u, lambda0);
+
+		op.bind(f);
+		op.predicted() = y;
+		fixParameter();
+
+		if(!correct())
+			return false;
+
+		getPoint(y, u);
+		y1 = y;
+		npoints = 1;
+
+		return true;
+	}
+
+	//! Computes the next point on the solution curve
+	/*!
+	 *  Upon input, u and lambda are ignored; upon return, they contain the
+	 *  new point on the solution curve. Returns false if the corrector failed
+	 *  to converge for the minimum step size, in which case u and lambda
+	 *  contain the last point computed.
+	 */
+	bool step(NL & f, VecType & u, Real & lambda)
+	{
+		ASSERT( u.size() == n );
+		ASSERT( npoints > 0 );
+
+		op.bind(f);
+
+		while(true)
+		{
+			predict();
+
+			if(correct())
+				break;
+
+			DEBUG_PRINT( "Corrector failed; reducing step size" );
+
+			ds *= 0.5;
+			if(std::fabs(ds) < ds_min)
+			{
+				getPoint(y1, u);
+				lambda = y1(n);
+				return false;
+			}
+		}
+
+		// Accept point...
+
+		y0 = y1;
+		y1 = y;
+		++npoints;
+
+		getPoint(y1, u);
+		lambda = y1(n);
+
+		// Adapt step size...
+
+		Real c = Real(target_iter)/Real(max(last_iter, Size(1)));
+		c = min(max(c, 0.5), 2.0);
+		ds = sgn(ds)*min(max(c*std::fabs(ds), ds_min), ds_max);
+
+		DEBUG_PRINT_VAR( ds );
+
+		return true;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( Continuation );
+
+	//! Rank of f
+	Size n;
+
+	//! Continuation strategy
+	ContinuationMode mode;
+
+	//! Corrector tolerance
+	Real tol;
+
+	//! Relative tolerance of the linear solves (forcing term)
+	Real eta;
+
+	//! Step size and its bounds
+	Real ds, ds_min, ds_max;
+
+	//! Maximum Newton iterations per corrector
+	Size max_iter;
+
+	//! Desired Newton iterations per corrector
+	Size target_iter;
+
+	//! Newton iterations used by the last corrector
+	Size last_iter;
+
+	//! Number of points computed
+	Size npoints;
+
+	//! Augmented nonlinear operator
+	OpType op;
+
+	//! Corrector
+	NewtonGMRES<T,OpType> newton;
+
+	//! Current estimate, and the last two points, (u, lambda)
+	VecType y, y0, y1;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	void setPoint(VecType & yy, const VecType & u, Real lambda) const
+	{
+		for(Index i=0; i<n; ++i)
+			yy(i) = u(i);
+		yy(n) = lambda;
+	}
+
+	void getPoint(const VecType & yy, VecType & u) const
+	{
+		for(Index i=0; i<n; ++i)
+			u(i) = yy(i);
+	}
+
+	// Sets the constraint to lambda = lambda_pred
+	void fixParameter()
+	{
+		VecType & c = op.constraint();
+		c.zero();
+		c(n) = 1.0;
+	}
+
+	// Sets y (and the predicted point) from the last one or two points
+	void predict()
+	{
+		VecType & c = op.constraint();
+		VecType & yp = op.predicted();
+
+		if(npoints < 2)
+		{
+			// Zeroth order predictor in u; advance lambda...
+			yp = y1;
+			yp(n) += ds;
+			fixParameter();
+		}
+		else if(mode == NATURAL_PARAMETER)
+		{
+			// Secant predictor with lambda step ds...
+			const Real dl = y1(n) - y0(n);
+			ASSERT( std::fabs(dl) > 0.0 );
+			const Real s = ds/dl;
+			for(Index i=0; i<=n; ++i)
+				yp(i) = y1(i) + s*(y1(i) - y0(i));
+			yp(n) = y1(n) + ds; /* avoids round-off in lambda */
+			fixParameter();
+		}
+		else
+		{
+			// Secant predictor with arclength step |ds|...
+			for(Index i=0; i<=n; ++i)
+				c(i) = y1(i) - y0(i);
+			const T cn = norm2(c);
+			ASSERT( cn > 0.0 );
+			c /= cn;
+			const Real s = std::fabs(ds);
+			for(Index i=0; i<=n; ++i)
+				yp(i) = y1(i) + s*c(i);
+		}
+
+		y = yp;
+	}
+
+	// Newton correction of y; returns true if converged
+	bool correct()
+	{
+		T rn = newton.newSequence(op, y);
+
+		last_iter = 0;
+		while( (rn > tol) and (last_iter < max_iter) )
+		{
+			newton.tolerance( max(eta*rn, 0.1*tol) );
+			rn = newton.iter(op, y);
+			++last_iter;
+
+			if( !(rn == rn) ) return false; /* NaN */
+		}
+
+		DEBUG_PRINT_VAR( last_iter );
+		DEBUG_PRINT_VAR( rn );
+
+		return rn <= tol;
+	}
+
+};
+
+}}//::numlib::solver
+
+#endif
@@ -33,12 +33,12 @@ public:
 	T solve(const T & beta, const HessType & hess, VecType & y)
 	{
 		// Initialize RHS...
-		VecType g(y.size() + 1);
+		g.resize(y.size() + 1);
 		g.zero();
 		g(0) = beta;
 
 		// Solve least square problem ...
-		HessType h(hess);
+		h = hess;
 		linalg::solveInPlaceLeastSquare(h, g); /* g over-written with soln and res norm*/
 
 		// Extract soln vector and residual norm...
@@ -59,11 +59,19 @@ public:
 	 */
 	void calc_residual(const T& beta, const HessType& hess, const VecType& y, VecType& r)
 	{
-		r = prod(hess, y);
+		prodIP(hess, y, r);
 		r *= -1.0;
 		r(0) += beta;
 	}
 
+private:
+
+	//! Least squares RHS work space (reused by successive solves)
+	VecType g;
+
+	//! Least squares coefficient work space (reused by successive solves)
+	HessType h;
+
 };
 
 }}//::numlib::solver
@@ -0,0 +1,147 @@
+/*! \file GateauxAD.h
+ */
+
+#ifndef GATEAUXAD_H
+#define GATEAUXAD_H
+
+#include "../base/nocopy.h"
+#include "../base/Dual.h"
+#include "../linalg/Vector.h"
+
+namespace numlib{ namespace solver{
+
+//! Automatic differentiation model of a Gateaux derivative operator
+/*!
+ *  Computes the Gateaux derivative of F:R^N -> R^N at vector u with
+ *  respect to vector v; i.e. D[f(u)]v, exactly (to round-off) by
+ *  evaluating f with forward mode dual numbers seeded with v. This is a
+ *  drop-in replacement for GateauxFD which avoids the finite difference
+ *  step size error; each evaluation costs one evaluation of f with
+ *  Dual<T,1> arithmetic.
+ *
+ *  The nonlinear operator, f, must implement eval as a template on the
+ *  numeric type, so that it may be evaluated with both T and Dual<T,1>
+ *  vectors; i.e.
+ *
+ *     template<class S>
+ *     void eval(const linalg::Vector< S > & u, linalg::Vector< S > & r);
+ *
+ *  The interface is otherwise identical to GateauxFD (f(u) is accepted for
+ *  compatibility, but is not needed).
+ */
+template<class T, class NL>
+class GateauxAD
+{
+public:
+
+	 typedef linalg::Vector<T> VecType;
+
+	 typedef Dual<T,1> DualType;
+
+	 typedef linalg::Vector<DualType> DualVecType;
+
+	 //! Creates an exact Gateaux operator for nonlinear operator f
+	 /*!
+	  *  f := Nonlinear operator to be differentiated
+	  *  u := Vector to evaluate point for the Gateaux derivative
+	  *  fu := Value of f(u) (unused)
+	  */
+	 GateauxAD(NL & f_, const VecType & u_, const VecType & /*fu*/):
+	    f(f_), u_copy(u_), u(&u_copy), ud(u_.size()), rd(u_.size())
+     {
+     }
+
+	 //! Creates an unbound Gateaux operator for nonlinear operator f
+	 /*!
+	  *  f := Nonlinear operator to be differentiated
+	  *  n := Rank of f
+	  *
+	  *  The operator must be bound to an evaluation point (see bind) before
+	  *  it is evaluated.
+	  */
+	 GateauxAD(NL & f_, Size n):
+	    f(f_), u_copy(0), u(0), ud(n), rd(n)
+     {
+     }
+
+	 ~GateauxAD() { /* nothing to delete */ }
+
+	 //! Sets the evaluation point of the Gateaux derivative by reference
+	 /*!
+	  *  u := Vector to evaluate point for the Gateaux derivative
+	  *  fu := Value of f(u) (unused)
+	  *
+	  *  WARNING: Only a reference to u is stored (u is not copied)! The
+	  *  vector must remain valid, and unmodified, for as long as this
+	  *  operator is evaluated at this point.
+	  */
+	 void bind(const VecType & u_, const VecType & /*fu*/)
+     {
+        ASSERT( u_.size() == ud.size() );
+        u = &u_;
+     }
+
+	 //! Evaluates the Gateaux derivative of f(u) with respect to v
+	 /*!
+	  *  Arguments:
+	  *  v := Vector to differentiate f(u) with respect to
+	  *  dfv := Exact derivative
+	  */
+	 void eval(const VecType & v, VecType & dfv) const
+     {
+         ASSERT( u != 0 );
+         ASSERT( v.size() == ud.size() );
+         ASSERT( dfv.size() == ud.size() );
+
+         for(Index i=0; i<ud.size(); ++i)
+         {
+             ud(i) = DualType((*u)(i));
+             ud(i).derivative(0) = v(i);
+         }
+
+         f.eval(ud, rd); /* rd = f(u + s*v) */
+
+         for(Index i=0; i<rd.size(); ++i)
+             dfv(i) = rd(i).derivative(0);
+     }
+
+private:
+
+	 DISALLOW_COPY_AND_ASSIGN( GateauxAD );
+
+	 //! Nonlinear operator f(u)
+	 NL & f;
+
+	 //! Copy of u (used only if u was provided at construction)
+	 VecType u_copy;
+
+	 //! Vector to in which the derivative is evaluated
+	 const VecType* u;
+
+	 //! Work vector holding the seeded dual solution
+	 mutable DualVecType ud;
+
+	 //! Work vector holding the dual residual
+	 mutable DualVecType rd;
+
+};
+
+//! Linear operator wrapper function for GateauxAD
+template<class T, class NL> inline
+linalg::Vector<T> prod(const GateauxAD<T,NL> & gateaux, const linalg::Vector<T> & v)
+{
+	 linalg::Vector<T> Jv(v.size());
+	 gateaux.eval(v, Jv);
+	 return Jv;
+}
+
+//! In-place linear operator wrapper function for GateauxAD
+template<class T, class NL> inline
+void prodIP(const GateauxAD<T,NL> & gateaux, const linalg::Vector<T> & v, linalg::Vector<T> & Jv)
+{
+	 gateaux.eval(v, Jv);
+}
+
+}}//::numlib::solver
+
+#endif
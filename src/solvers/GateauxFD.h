@@ -20,6 +20,12 @@ namespace numlib{ namespace solver{
  *  Brown and Saad (Brown, Peter N., Youcef Saad. "Hybrid Krylov 
  *  Methods for Nonlinear Systems of Equations." SIAM J. Sci. Stat. 
  *  Comput. Vol. 11, No. 3, pp. 450-481, May 1990).
+ *
+ *  By default, the vectors u and f(u) are copied when the operator is
+ *  constructed. Solvers which already hold u and f(u) for the duration of
+ *  the linear solve may instead construct an unbound operator and bind it
+ *  to their vectors by reference (see bind); this avoids two vector copies
+ *  per Newton iteration.
  */
 template<class T, class NL>
 class GateauxFD
@@ -40,11 +46,43 @@ public:
 	  *  This saves a potentially costly function evaluation.
 	  */
 	 GateauxFD(NL & f_, const VecType & u_, const VecType & fu_):
-	    eps(1.0E-9), f(f_), u(u_), fu(fu_)
+	    eps(1.0E-9), f(f_), u_copy(u_), fu_copy(fu_), u(&u_copy), fu(&fu_copy),
+	    upert(u_.size())
      {
         eps = std::sqrt(eps);
      }
 
+	 //! Creates an unbound Gateaux operator for nonlinear operator f
+	 /*!
+	  *  f := Nonlinear operator to be differentiated
+	  *  n := Rank of f
+	  *
+	  *  The operator must be bound to an evaluation point (see bind) before
+	  *  it is evaluated.
+	  */
+	 GateauxFD(NL & f_, Size n):
+	    eps(1.0E-9), f(f_), u_copy(0), fu_copy(0), u(0), fu(0), upert(n)
+     {
+        eps = std::sqrt(eps);
+     }
+
+	 //! Sets the evaluation point of the Gateaux derivative by reference
+	 /*!
+	  *  u := Vector to evaluate point for the Gateaux derivative
+	  *  fu := Value of f(u)
+	  *
+	  *  WARNING: Only references to u and fu are stored (u and fu are not
+	  *  copied)! Both vectors must remain valid, and unmodified, for as long
+	  *  as this operator is evaluated at this point.
+	  */
+	 void bind(const VecType & u_, const VecType & fu_)
+     {
+        ASSERT( u_.size() == upert.size() );
+        ASSERT( fu_.size() == upert.size() );
+        u = &u_;
+        fu = &fu_;
+     }
+
 	 ~GateauxFD() { /* nothing to delete */ }
 
 	 //! Evaluates the Gateaux derivative of f(u) with respect to v
@@ -55,6 +93,7 @@ public:
 	  */
 	 void eval(const VecType & v, VecType & dfv) const
      {
+         ASSERT( u != 0 );
          ASSERT( v.size() == dfv.size() );
          ASSERT( &v != &dfv );
          
@@ -62,10 +101,8 @@ public:
          
          Real h = eps;
          
-         dfv = abs(v); /* temporarily store |v| in dfv */
-         
-         Real uTv = prod(u,v);
-         Real uTv_abs = fabs(uTv);
+         Real uTv = prod(*u,v);
+         Real uTv_abs = std::fabs(uTv);
          Real uTv_sign = 1;
          if(uTv < 0) uTv_sign = -1;
          Real vn = norm2(v);
@@ -74,18 +111,18 @@ public:
          
          h = (eps/vn)*max(uTv_abs, eps)*uTv_sign;
          
-         ASSERT( fabs(h) > 0 );
+         ASSERT( std::fabs(h) > 0 );
          
          DEBUG_PRINT_VAR( h );
          
          // Compute perturbed solution and evaluate finite difference...
          
-         VecType upert(v);
+         upert  =  v;
          upert *=  h;
-         upert +=  u;
+         upert += *u;
          f.eval(upert, dfv); /* dfv = f(u+h*v) */
          
-         dfv -= fu;   /* dfv = f(u+h*v) - f(u)     */
+         dfv -= *fu;  /* dfv = f(u+h*v) - f(u)     */
          dfv /= h;    /* dfv = [f(u+h*v) - f(u)]/h */
      }
 
@@ -99,11 +136,20 @@ private:
 	 //! Nonlinear operator f(u)
 	 NL & f;
 
+	 //! Copy of u (used only if u was provided at construction)
+	 VecType u_copy;
+
+	 //! Copy of f(u) (used only if f(u) was provided at construction)
+	 VecType fu_copy;
+
 	 //! Vector to in which the derivative is evaluated
-	 VecType u;
+	 const VecType* u;
 
 	 //! Value of nonliner operator f evaluated at u, i.e. f(u).
-	 VecType fu;
+	 const VecType* fu;
+
+	 //! Work vector holding the perturbed solution u + h*v
+	 mutable VecType upert;
 
 };
 
@@ -116,6 +162,13 @@ linalg::Vector<T> prod(const GateauxFD<T,NL> & gateaux, const linalg::Vector<T>
 	 return Jv;
 }
 
+//! In-place linear operator wrapper function for GateauxFD
+template<class T, class NL> inline
+void prodIP(const GateauxFD<T,NL> & gateaux, const linalg::Vector<T> & v, linalg::Vector<T> & Jv)
+{
+	 gateaux.eval(v, Jv);
+}
+
 }}//::numlib::solver
 
 #endif
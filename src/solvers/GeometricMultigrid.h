@@ -0,0 +1,638 @@
+/*! \file GeometricMultigrid.h
+ */
+
+#ifndef GEOMETRICMULTIGRID_H
+#define GEOMETRICMULTIGRID_H
+
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../array/Array1D.h"
+#include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
+#include "../linalg/TriMatrix.h"
+#include "../linalg/TriMatrixExpressions.h"
+#include "../linalg/StencilMatrix.h"
+#include "../linalg/StencilMatrixExpressions.h"
+#include "../reconstruction/LinearPW.h"
+
+namespace numlib{ namespace solver{
+
+//! Multigrid cycle types
+enum MultigridCycle
+{
+	V_CYCLE,
+	W_CYCLE,
+	F_CYCLE
+};
+
+//! Multigrid smoother types
+enum MultigridSmoother
+{
+	WEIGHTED_JACOBI,  /* point Jacobi with damping */
+	LINE_GAUSS_SEIDEL /* Gauss-Seidel by lines, alternating over the axes */
+};
+
+//! Tensor product (1D, 2D, or 3D) structured grid
+/*!
+ *  Defined by the node coordinates along each axis, which must be in
+ *  ascending order. Nodes are ordered as for linalg::StencilMatrix.
+ */
+class StructuredGrid
+{
+public:
+
+	typedef array::Array1D<Real> CoordArray;
+
+	StructuredGrid(): d(0) {}
+
+	StructuredGrid(const CoordArray & x0): d(1)
+	{
+		x[0] = x0;
+		x[1] = point();
+		x[2] = point();
+	}
+
+	StructuredGrid(const CoordArray & x0, const CoordArray & x1): d(2)
+	{
+		x[0] = x0;
+		x[1] = x1;
+		x[2] = point();
+	}
+
+	StructuredGrid(const CoordArray & x0, const CoordArray & x1,
+		const CoordArray & x2): d(3)
+	{
+		x[0] = x0;
+		x[1] = x1;
+		x[2] = x2;
+	}
+
+	//! Returns the grid dimension
+	Size dim() const { return d; }
+
+	//! Returns the number of nodes along axis a (1 for unused axes)
+	Size size(Index a) const { ASSERT( a < 3 ); return x[a].size(); }
+
+	//! Returns the total number of nodes
+	Size points() const { return x[0].size()*x[1].size()*x[2].size(); }
+
+	//! Returns the node coordinates along axis a
+	const CoordArray & coord(Index a) const { ASSERT( a < 3 ); return x[a]; }
+
+	//! Returns true if any axis may be coarsened
+	bool coarsenable() const
+	{
+		for(Index a=0; a<d; ++a)
+			if(x[a].size() > 3) return true;
+		return false;
+	}
+
+	//! Returns the grid obtained by removing every other node along each axis
+	/*!
+	 *  The first and last node along each axis are retained. Axes with 3 or
+	 *  fewer nodes are not coarsened.
+	 */
+	StructuredGrid coarsen() const
+	{
+		StructuredGrid g(*this);
+		for(Index a=0; a<d; ++a)
+		{
+			const Size n = x[a].size();
+			if(n <= 3) continue;
+			const Size nc = (n + 1)/2 + ((n % 2 == 0) ? 1 : 0);
+			CoordArray xc(nc);
+			for(Index i=0; i<nc-1; ++i)
+				xc(i) = x[a](2*i);
+			xc(nc-1) = x[a](n-1);
+			g.x[a] = xc;
+		}
+		return g;
+	}
+
+private:
+
+	//! Grid dimension
+	Size d;
+
+	//! Node coordinates along each axis
+	CoordArray x[3];
+
+	static CoordArray point()
+	{
+		CoordArray p(1);
+		p(0) = 0.0;
+		return p;
+	}
+
+};
+
+//! Geometric multigrid solver/preconditioner for structured grids
+/*!
+ *  Solves A*u = f, where A is a compact stencil operator (StencilMatrix) on a
+ *  1D, 2D, or 3D structured grid. A hierarchy of grids is formed by
+ *  repeatedly removing every other node along each axis, and the operator is
+ *  rediscretized on each grid by the user supplied discretization, disc,
+ *  which is called once per level at construction as
+ *
+ *     disc(const StructuredGrid & grid, linalg::StencilMatrix<T> & A);
+ *
+ *  with A sized to the grid. Boundary nodes are expected to be part of the
+ *  grid; e.g. Dirichlet conditions are imposed by identity rows. The
+ *  residual of such decoupled rows (rows without off-diagonal coefficients)
+ *  is injected, rather than restricted, to the coarse grid.
+ *
+ *  Prolongation is tensor product piece-wise linear interpolation
+ *  (reconstruction::LinearPW along each coarsened axis), and restriction is
+ *  its transpose scaled by 1/2 per coarsened axis (full weighting on uniform
+ *  grids). Smoothing is either damped point Jacobi or line Gauss-Seidel,
+ *  which solves for each grid line (by the Thomas algorithm) in turn,
+ *  alternating over the axes; the latter is robust for anisotropic
+ *  operators and stretched grids. V, W, and F cycles are supported. The
+ *  coarsest grid is solved approximately by repeated smoothing.
+ *
+ *  The solver may be used standalone (see solve), or as a preconditioner
+ *  (see apply, and PreconditionedOperator); either way, the work per cycle is
+ *  proportional to the number of grid nodes.
+ */
+template<class T>
+class GeometricMultigrid
+{
+public:
+
+	typedef linalg::Vector<T> VecType;
+
+	typedef linalg::StencilMatrix<T> MatType;
+
+	//! Builds the grid hierarchy and the operator on each level
+	/*!
+	 *  Arguments:
+	 *    disc: discretization of the operator (see class description)
+	 *    grid: finest grid
+	 *    max_levels: maximum number of grid levels
+	 */
+	template<class D>
+	GeometricMultigrid(D & disc, const StructuredGrid & grid, Size max_levels=20):
+		nlev(0), levels(0), cycle_type(V_CYCLE), smoother_type(WEIGHTED_JACOBI),
+		npre(2), npost(2), ncoarse(50), omega(2.0/3.0), ncycles(0)
+	{
+		ASSERT( max_levels > 0 );
+
+		// Count levels...
+
+		StructuredGrid g(grid);
+		nlev = 1;
+		while( (nlev < max_levels) and g.coarsenable() )
+		{
+			g = g.coarsen();
+			++nlev;
+		}
+
+		DEBUG_PRINT_VAR( nlev );
+
+		// Build levels...
+
+		levels = new Level[nlev];
+
+		g = grid;
+		for(Index l=0; l<nlev; ++l)
+		{
+			if(l > 0) g = g.coarsen();
+			levels[l].init(g);
+			disc(levels[l].grid, levels[l].A);
+		}
+
+		for(Index l=0; l+1<nlev; ++l)
+			levels[l].initTransfer(levels[l+1].grid);
+	}
+
+	~GeometricMultigrid()
+	{
+		delete[] levels;
+	}
+
+	//! Sets cycle type
+	void cycleType(MultigridCycle type) { cycle_type = type; }
+
+	//! Returns cycle type
+	MultigridCycle cycleType() const { return cycle_type; }
+
+	//! Sets smoother type
+	void smoother(MultigridSmoother type) { smoother_type = type; }
+
+	//! Returns smoother type
+	MultigridSmoother smoother() const { return smoother_type; }
+
+	//! Sets number of pre- and post-smoothing sweeps
+	void smoothingSteps(Size npre_, Size npost_) { npre = npre_; npost = npost_; }
+
+	//! Sets number of smoothing sweeps used to solve on the coarsest grid
+	void coarseSweeps(Size n) { ncoarse = n; }
+
+	//! Sets damping factor of the Jacobi smoother
+	void jacobiWeight(Real omega_) { omega = omega_; }
+
+	//! Returns damping factor of the Jacobi smoother
+	Real jacobiWeight() const { return omega; }
+
+	//! Returns the number of grid levels
+	Size numLevels() const { return nlev; }
+
+	//! Returns the grid of level l (l = 0 is the finest)
+	const StructuredGrid & grid(Index l) const { ASSERT( l < nlev ); return levels[l].grid; }
+
+	//! Returns the operator of level l (l = 0 is the finest)
+	const MatType & op(Index l) const { ASSERT( l < nlev ); return levels[l].A; }
+
+	//! Returns the number of cycles executed by the last call to solve
+	Size cycles() const { return ncycles; }
+
+	//! Solves A*x = b by repeated cycles
+	/*!
+	 *  Upon input, x contains the initial guess. Cycles are executed until
+	 *  the residual 2-norm is less than tol, or max_cycles is reached. The
+	 *  residual 2-norm is returned.
+	 */
+	T solve(const VecType & b, VecType & x, Real tol, Size max_cycles=100)
+	{
+		Level & fine = levels[0];
+
+		ASSERT( b.size() == fine.u.size() );
+		ASSERT( x.size() == fine.u.size() );
+
+		fine.f = b;
+		fine.u = x;
+
+		linalg::residual(fine.A, fine.u, fine.f, fine.r);
+		T rn = norm2(fine.r);
+
+		ncycles = 0;
+		while( (rn > tol) and (ncycles < max_cycles) )
+		{
+			cycle(0, cycle_type);
+			++ncycles;
+
+			linalg::residual(fine.A, fine.u, fine.f, fine.r);
+			rn = norm2(fine.r);
+
+			DEBUG_PRINT_VAR( rn );
+		}
+
+		x = fine.u;
+
+		return rn;
+	}
+
+	//! Applies one cycle, with zero initial guess, to r; i.e. z = M^{-1}*r
+	/*!
+	 *  This is the preconditioner interface (see PreconditionedOperator).
+	 */
+	void apply(const VecType & r, VecType & z)
+	{
+		Level & fine = levels[0];
+
+		ASSERT( r.size() == fine.u.size() );
+
+		fine.f = r;
+		fine.u.zero();
+		cycle(0, cycle_type);
+		z = fine.u;
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( GeometricMultigrid );
+
+	typedef array::Array1D<T> LineType;
+
+	typedef reconstruction::LinearPW<StructuredGrid::CoordArray, LineType> InterpType;
+
+	//! Grid level data
+	struct Level
+	{
+		StructuredGrid grid;
+		MatType A;
+		VecType u, f, r;      /* solution, right hand side, residual */
+		VecType w1, w2;       /* transfer work space */
+		Size n[3];            /* grid size */
+		InterpType* interp[3];/* prolongation from the next coarser level */
+		LineType lineF[3];    /* fine grid line */
+		LineType lineC[3];    /* coarse grid line */
+		linalg::TriMatrix<T> tri[3]; /* line smoother systems */
+		VecType rhs[3];       /* line smoother right hand sides */
+
+		Level()
+		{
+			for(Index a=0; a<3; ++a) interp[a] = 0;
+		}
+
+		~Level()
+		{
+			for(Index a=0; a<3; ++a) delete interp[a];
+		}
+
+		void init(const StructuredGrid & g)
+		{
+			grid = g;
+			for(Index a=0; a<3; ++a)
+			{
+				n[a] = g.size(a);
+				lineF[a].resize(n[a]);
+				tri[a].resize(n[a]);
+				rhs[a].resize(n[a]);
+			}
+			const Size np = g.points();
+			A.resize(n[0], n[1], n[2]);
+			u.resize(np); u.zero();
+			f.resize(np); f.zero();
+			r.resize(np); r.zero();
+			w1.resize(np);
+			w2.resize(np);
+		}
+
+		void initTransfer(const StructuredGrid & gc)
+		{
+			for(Index a=0; a<grid.dim(); ++a)
+			{
+				lineC[a].resize(gc.size(a));
+				if(gc.size(a) != n[a])
+					interp[a] = new InterpType(gc.coord(a), grid.coord(a));
+			}
+		}
+
+	private:
+
+		DISALLOW_COPY_AND_ASSIGN( Level );
+	};
+
+	//! Number of levels
+	Size nlev;
+
+	//! Grid levels (finest first)
+	Level* levels;
+
+	//! Cycle type
+	MultigridCycle cycle_type;
+
+	//! Smoother type
+	MultigridSmoother smoother_type;
+
+	//! Number of pre- and post-smoothing sweeps
+	Size npre, npost;
+
+	//! Number of smoothing sweeps on the coarsest grid
+	Size ncoarse;
+
+	//! Jacobi damping factor
+	Real omega;
+
+	//! Number of cycles executed by the last solve
+	Size ncycles;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Executes a cycle of given type on level l
+	void cycle(Index l, MultigridCycle type)
+	{
+		Level & fine = levels[l];
+
+		if(l+1 == nlev)
+		{
+			smooth(fine, ncoarse);
+			return;
+		}
+
+		Level & coarse = levels[l+1];
+
+		// Pre-smoothing...
+
+		smooth(fine, npre);
+
+		// Coarse grid correction...
+
+		linalg::residual(fine.A, fine.u, fine.f, fine.r);
+		restrictResidual(fine, coarse);
+		coarse.u.zero();
+
+		if(type == V_CYCLE)
+		{
+			cycle(l+1, V_CYCLE);
+		}
+		else if(type == W_CYCLE)
+		{
+			cycle(l+1, W_CYCLE);
+			cycle(l+1, W_CYCLE);
+		}
+		else
+		{
+			cycle(l+1, F_CYCLE);
+			cycle(l+1, V_CYCLE);
+		}
+
+		prolongAdd(coarse, fine);
+
+		// Post-smoothing...
+
+		smooth(fine, npost);
+	}
+
+	void smooth(Level & lev, Size sweeps)
+	{
+		if(smoother_type == WEIGHTED_JACOBI)
+			smoothJacobi(lev, sweeps);
+		else
+			smoothLines(lev, sweeps);
+	}
+
+	void smoothJacobi(Level & lev, Size sweeps)
+	{
+		const Size np = lev.u.size();
+		for(Index s=0; s<sweeps; ++s)
+		{
+			linalg::residual(lev.A, lev.u, lev.f, lev.r);
+
+			#pragma omp parallel for
+			for(Index p=0; p<np; ++p)
+				lev.u(p) += omega*lev.r(p)/lev.A.center(p);
+		}
+	}
+
+	void smoothLines(Level & lev, Size sweeps)
+	{
+		for(Index s=0; s<sweeps; ++s)
+			for(Index a=0; a<lev.grid.dim(); ++a)
+				if(lev.n[a] > 1) smoothLine(lev, a);
+	}
+
+	// Gauss-Seidel sweep over the grid lines parallel to axis a
+	void smoothLine(Level & lev, Index a)
+	{
+		const MatType & A = lev.A;
+		const Size d = A.dim();
+		const Size* n = lev.n;
+		const Size m = n[a];
+		const Size sa = A.stride(a);
+
+		linalg::TriMatrix<T> & tri = lev.tri[a];
+		VecType & rhs = lev.rhs[a];
+
+		Size rng[3] = { n[0], n[1], n[2] };
+		rng[a] = 1;
+
+		for(Index k=0; k<rng[2]; ++k)
+		for(Index j=0; j<rng[1]; ++j)
+		for(Index i=0; i<rng[0]; ++i)
+		{
+			Index idx[3] = { i, j, k };
+			const Index base = i + n[0]*(j + n[1]*k);
+
+			for(Index q=0; q<m; ++q)
+			{
+				const Index p = base + q*sa;
+				idx[a] = q;
+
+				tri.diag(q) = A.center(p);
+				tri.lower(q) = (q > 0) ? A.lower(p,a) : T(0);
+				tri.upper(q) = (q+1 < m) ? A.upper(p,a) : T(0);
+
+				T b = lev.f(p);
+				for(Index e=0; e<d; ++e)
+				{
+					if(e == a) continue;
+					const Size se = A.stride(e);
+					if(idx[e] > 0)      b -= A.lower(p,e)*lev.u(p-se);
+					if(idx[e]+1 < n[e]) b -= A.upper(p,e)*lev.u(p+se);
+				}
+				rhs(q) = b;
+			}
+
+			linalg::solveThomas(tri, rhs);
+
+			for(Index q=0; q<m; ++q)
+				lev.u(base + q*sa) = rhs(q);
+		}
+	}
+
+	// Applies the 1D operator of axis a to all lines of in (shape sin)
+	/*!
+	 *  The result is stored in out, whose shape (sout) differs from sin only
+	 *  along axis a. If restrict_ is true, the scaled transpose is applied.
+	 */
+	void applyAxis(Level & lev, Index a, const VecType & in, const Size* sin,
+		VecType & out, const Size* sout, bool restrict_)
+	{
+		LineType & lineF = lev.lineF[a];
+		LineType & lineC = lev.lineC[a];
+		LineType & lineIn  = restrict_ ? lineF : lineC;
+		LineType & lineOut = restrict_ ? lineC : lineF;
+
+		const Size strideIn  = (a == 0) ? 1 : (a == 1) ? sin[0]  : sin[0]*sin[1];
+		const Size strideOut = (a == 0) ? 1 : (a == 1) ? sout[0] : sout[0]*sout[1];
+
+		Size rng[3] = { sin[0], sin[1], sin[2] };
+		rng[a] = 1;
+
+		for(Index k=0; k<rng[2]; ++k)
+		for(Index j=0; j<rng[1]; ++j)
+		for(Index i=0; i<rng[0]; ++i)
+		{
+			const Index baseIn  = i + sin[0]*(j + sin[1]*k);
+			const Index baseOut = i + sout[0]*(j + sout[1]*k);
+
+			for(Index q=0; q<sin[a]; ++q)
+				lineIn(q) = in(baseIn + q*strideIn);
+
+			if(restrict_)
+			{
+				lev.interp[a]->transpose(lineIn, lineOut);
+				for(Index q=0; q<sout[a]; ++q)
+					out(baseOut + q*strideOut) = 0.5*lineOut(q);
+			}
+			else
+			{
+				(*lev.interp[a])(lineIn, lineOut);
+				for(Index q=0; q<sout[a]; ++q)
+					out(baseOut + q*strideOut) = lineOut(q);
+			}
+		}
+	}
+
+	// Restricts the residual of the fine level to the rhs of the coarse level
+	void restrictResidual(Level & fine, Level & coarse)
+	{
+		Size shape[3] = { fine.n[0], fine.n[1], fine.n[2] };
+		const VecType* in = &fine.r;
+		VecType* out = &fine.w1;
+
+		for(Index a=0; a<3; ++a)
+		{
+			if(fine.interp[a] == 0) continue;
+			Size oshape[3] = { shape[0], shape[1], shape[2] };
+			oshape[a] = coarse.n[a];
+			applyAxis(fine, a, *in, shape, *out, oshape, true);
+			shape[a] = oshape[a];
+			in = out;
+			out = (out == &fine.w1) ? &fine.w2 : &fine.w1;
+		}
+
+		for(Index p=0; p<coarse.f.size(); ++p)
+			coarse.f(p) = (*in)(p);
+
+		// Inject the residual of decoupled (e.g. Dirichlet) rows...
+
+		const Size* nc = coarse.n;
+		for(Index k=0; k<nc[2]; ++k)
+		for(Index j=0; j<nc[1]; ++j)
+		for(Index i=0; i<nc[0]; ++i)
+		{
+			const Index p = i + nc[0]*(j + nc[1]*k);
+			if(not decoupled(coarse.A, p)) continue;
+			const Index pf = fineNode(fine, coarse, 0, i) + fine.n[0]*(
+				fineNode(fine, coarse, 1, j) + fine.n[1]*fineNode(fine, coarse, 2, k));
+			coarse.f(p) = fine.r(pf);
+		}
+	}
+
+	// Returns true if row p of A has no off-diagonal coefficients
+	static bool decoupled(const MatType & A, Index p)
+	{
+		for(Index a=0; a<A.dim(); ++a)
+			if( (A.lower(p,a) != T(0)) or (A.upper(p,a) != T(0)) ) return false;
+		return true;
+	}
+
+	// Returns the fine grid node (along axis a) coincident with coarse node q
+	static Index fineNode(const Level & fine, const Level & coarse, Index a, Index q)
+	{
+		if(fine.interp[a] == 0) return q;
+		return (q+1 == coarse.n[a]) ? fine.n[a]-1 : 2*q;
+	}
+
+	// Prolongs the solution of the coarse level, and adds it to the fine level
+	void prolongAdd(Level & coarse, Level & fine)
+	{
+		Size shape[3] = { coarse.n[0], coarse.n[1], coarse.n[2] };
+		const VecType* in = &coarse.u;
+		VecType* out = &fine.w1;
+
+		for(Index a=0; a<3; ++a)
+		{
+			if(fine.interp[a] == 0) continue;
+			Size oshape[3] = { shape[0], shape[1], shape[2] };
+			oshape[a] = fine.n[a];
+			applyAxis(fine, a, *in, shape, *out, oshape, false);
+			shape[a] = oshape[a];
+			in = out;
+			out = (out == &fine.w1) ? &fine.w2 : &fine.w1;
+		}
+
+		for(Index p=0; p<fine.u.size(); ++p)
+			fine.u(p) += (*in)(p);
+	}
+
+};
+
+}}//::numlib::solver
+
+#endif
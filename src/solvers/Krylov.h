@@ -9,6 +9,7 @@
 #include "../linalg/VectorExpressions.h"
 #include "../linalg/ExtHessMatrix.h"
 #include "../linalg/ExtHessMatrixExpressions.h"
+#include "../linalg/LinearOperator.h"
 
 namespace numlib{ namespace solver{
 
@@ -27,9 +28,6 @@ namespace numlib{ namespace solver{
  *  NOTE: This is code is experimental and subject to revision. Future versions
  *  may not be backwards compatible with old implemenations--caveat emptor.
  *  
- *  \todo Replace use of function prod with an in-place matrix vector product 
- *   to avoid temporaries (e.g. prodIP).
- *
  *  \todo Could also implement this as a template function instead?
  */
 template<class T, class L, class K, class P>
@@ -40,7 +38,8 @@ public:
 	 typedef linalg::Vector<T> VecType;
 	 typedef linalg::ExtHessMatrix<T> HessType;
 
-     Krylov(Size n_, Size mmax_):n(n_),m(0),mmax(mmax_),krylovSpace(n_,mmax_)
+     Krylov(Size n_, Size mmax_):
+        n(n_),m(0),mmax(mmax_),krylovSpace(n_,mmax_),z(n_),hess(mmax_),y(mmax_),rk(mmax_+1)
      {
         ASSERT(mmax <= n);
      }
@@ -58,7 +57,11 @@ public:
         
         // Compute residual due to initial guess x...
         r = b;
-        if(norm2(x) > zero) r -= prod(linO, x);
+        if(norm2(x) > zero)
+        {
+            prodIP(linO, x, z);
+            r -= z;
+        }
         
         T beta = norm2(r);
         T rn = beta;
@@ -68,12 +71,11 @@ public:
         m = krylovSpace.size();
         
         // Get the projection of A (i.e. 'linO') on the Krylov subspace...
-        HessType hess(m);
+        hess.resize(m);
         krylovSpace.projA(hess);
         
         // Compute correction vector...
-        VecType y(m);
-        VecType z(n);
+        y.resize(m);
         rn = projectionScheme.solve(beta, hess, y); /* GMRES or Galerkin projection */
         krylovSpace.map(y, z);
         
@@ -83,7 +85,7 @@ public:
 		// Compute residual vector...
 		// -- This is needed for globalization schemes like line backtracking.
 		// -- This is an ugly way to do it, but it'll do for now.
-		VecType rk(m+1);
+		rk.resize(m+1);
 		projectionScheme.calc_residual(beta, hess, y, rk);
 		krylovSpace.map(rk, r);
         
@@ -108,6 +110,22 @@ private:
 
 	 P projectionScheme;
 
+	 //! Correction vector work space
+	 VecType z;
+
+	 //! Projection of the linear operator onto the Krylov subspace
+	 /*!
+	  *  The subspace work space (hess, y, and rk) is allocated for the maximum
+	  *  subspace dimension, and resized (without reallocation) on each solve.
+	  */
+	 HessType hess;
+
+	 //! Subspace correction vector
+	 VecType y;
+
+	 //! Subspace residual vector
+	 VecType rk;
+
 };
 
 }}//::numlib::solver
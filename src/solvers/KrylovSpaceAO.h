@@ -8,7 +8,9 @@
 #include "../base/nocopy.h"
 #include "../base/numlib-config.h"
 #include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
 #include "../linalg/HessMatrix.h"
+#include "../linalg/LinearOperator.h"
 
 namespace numlib{ namespace solver{
 
@@ -25,8 +27,9 @@ namespace numlib{ namespace solver{
  *
  *  NOTES:
  *  1. Linear operator type is any type that maps a vector to another vector via
- *     the matrix-vector product function, v = prod(A, u), where A is an intance
- *     of the linear operator. The operator A need not be a matrix type. Examples
+ *     the in-place matrix-vector product function, prodIP(A, u, v), or the
+ *     matrix-vector product function, v = prod(A, u), where A is an intance
+ *     of the linear operator (see LinearOperator.h). The operator A need not be a matrix type. Examples
  *     of non-matrix type examples of A include Fast-Multipole expansions, and 
  *     directional derivatives of a nonlinear operator.
  */
@@ -46,7 +49,7 @@ public:
 	  *  The initial dimension of the Krylov space is 0.
 	  */
 	 KrylovSpaceAO(Size n_, Size maxSpaceDim):
-        n(n_),m(0),mmax(maxSpaceDim),basis(0),hess(mmax)
+        n(n_),m(0),mmax(maxSpaceDim),basis(0),hess(mmax),v(n_)
      {
         const Size n_basis = mmax+1;
         basis = new VecType[n_basis];
@@ -75,7 +78,7 @@ public:
         m = 0;
         
         // Seed Krylov space using normalized residual vector...
-        VecType v(r);
+        v = r;
         T beta = norm2(v);
         if(beta < tol) return; /* "happy breakdown" */
         v /= beta;
@@ -90,14 +93,14 @@ public:
              ++m;
              
              // Compute j+1 Krylov basis v_{j+1} = A v_{j} ...
-             v = prod(linO, v);
+             prodIP(linO, basis[j], v);
              // Project v onto existing orthonormal basis...
              for(Index i=0; i<m; ++i)
                hess(i,j) = prod(v,basis[i]);
              
              // Reduce v to it's ortho component...
              for(Index i=0; i<m; ++i)
-               v -= hess(i,j)*basis[i];
+               axpy(-hess(i,j), basis[i], v);
              
              // Normalize v...
              T h = norm2(v);
@@ -136,7 +139,7 @@ public:
      {
         z.zero();
         for(Index i=0; i<y.size(); ++i)
-            z += basis[i]*y(i);
+            axpy(y(i), basis[i], z);
      }
 
 private:
@@ -158,6 +161,9 @@ private:
 	 //! Matrix representation of A in K
 	 HessType hess;
 
+	 //! Work vector holding the basis vector under construction
+	 VecType v;
+
 };
 
 }}//::numlib::solver
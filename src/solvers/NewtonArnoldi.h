@@ -15,14 +15,14 @@ namespace numlib{ namespace solver{
  *  Specialization of NewtonKrylov nonlinear solver framework which uses
  *  Arnoldi's method (FOM) for the "inner" linear iteration.
  */
-template<class T, class NL>
+template<class T, class NL, class G = GateauxFD< T, NL > >
 class NewtonArnoldi: 
-    public NewtonKrylov< T, NL, KrylovSpaceAO< T, GateauxFD< T, NL > >, GalerkinProjection< T > >
+    public NewtonKrylov< T, NL, KrylovSpaceAO< T, G >, GalerkinProjection< T >, G >
 {
 public:
 
     NewtonArnoldi(Size n_, Size mmax_, Size lmax_, Real tol_):
-	    NewtonKrylov< T, NL, KrylovSpaceAO< T, GateauxFD< T, NL > >, GalerkinProjection<T> >
+	    NewtonKrylov< T, NL, KrylovSpaceAO< T, G >, GalerkinProjection<T>, G >
         (n_, mmax_, lmax_, tol_) { }
 
 private:
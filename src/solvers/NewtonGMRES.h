@@ -12,20 +12,21 @@ namespace numlib{ namespace solver{
 //! Newton-GMRES nonlinear solver
 /*!
  *	Specialization of NewtonKrylov nonlinear solver framework which uses
- *	GMRES for the "inner" linear iteration.
+ *	GMRES for the "inner" linear iteration. The Gateaux operator type, G,
+ *	may be set to GateauxAD for exact Jacobian-vector products.
  */
-template<class T, class NL>
+template<class T, class NL, class G = GateauxFD<T,NL> >
 class NewtonGMRES:
 	public NewtonKrylov<T,NL,
-					    KrylovSpaceAO<T,GateauxFD<T,NL> >,
-						GMRESProjection<T> >
+					    KrylovSpaceAO<T,G>,
+						GMRESProjection<T>,G>
 {
 public:
 
 	NewtonGMRES(Size n_, Size mmax_, Size lmax_, Real tol_):
 		NewtonKrylov<T,NL,
-			KrylovSpaceAO<T,GateauxFD<T,NL> >,
-			GMRESProjection<T> >(n_, mmax_, lmax_, tol_)
+			KrylovSpaceAO<T,G>,
+			GMRESProjection<T>,G>(n_, mmax_, lmax_, tol_)
 	{}
 
 private:
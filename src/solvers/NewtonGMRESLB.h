@@ -9,14 +9,14 @@
 
 namespace numlib{ namespace solver{
 
-template<class T, class NL>
+template<class T, class NL, class G = GateauxFD<T,NL> >
 class NewtonGMRESLB:
-	public NewtonKrylovLB<T,NL,KrylovSpaceAO<T,GateauxFD<T,NL> >,GMRESProjection<T> >
+	public NewtonKrylovLB<T,NL,KrylovSpaceAO<T,G>,GMRESProjection<T>,G>
 {
 public:
 
 	NewtonGMRESLB(NL& f_, Size n_, Size mmax_, T alpha_, T beta_, T lambda_min_):
-		NewtonKrylovLB<T,NL,KrylovSpaceAO<T,GateauxFD<T,NL> >,GMRESProjection<T> >
+		NewtonKrylovLB<T,NL,KrylovSpaceAO<T,G>,GMRESProjection<T>,G>
 		(f_, n_, mmax_, alpha_, beta_, lambda_min_)
 		{}
 
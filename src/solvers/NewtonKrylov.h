@@ -33,9 +33,14 @@ namespace numlib{ namespace solver{
  *  a survey of approaches and applications." Journal of Computational Physics
  *  193 (2004) 357-397.)
  *
+ *  The Jacobian-vector products are evaluated by the Gateaux operator type G;
+ *  by default, GateauxFD (finite differences). If f implements eval as a
+ *  template on its numeric type, GateauxAD may be used instead for exact
+ *  products. The Krylov space type, K, must be defined on the same operator.
+ *
  *  \todo Implement linear preconditioning and scaling.
  */
-template<class T, class NL, class K, class P>
+template<class T, class NL, class K, class P, class G = GateauxFD<T,NL> >
 class NewtonKrylov
 {
 public:
@@ -88,7 +93,7 @@ public:
      
      	 // Create approximate Gateaux operator...
      
-     	 GateauxFD<T,NL> gateaux(f, u, r); /* r = f(u) */
+     	 G gateaux(f, u, r); /* r = f(u) */
      
      	 // Set initial guess for linear problem...
      
@@ -170,7 +175,7 @@ private:
 	 T rn;
 
 	 //! Linear Krylov Solver
-	 Krylov<T,GateauxFD<T,NL>,K,P> krylov;
+	 Krylov<T,G,K,P> krylov;
 
 	 //! Linear Krylov convergent history
 	 RealList convHist;
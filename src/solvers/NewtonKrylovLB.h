@@ -4,6 +4,8 @@
 #define NEWTON_KRYLOV_LB_H
 
 #include <list>
+#include "../base/parallel_tools.h"
+#include "../array/Array1D.h"
 #include "Krylov.h"
 #include "GateauxFD.h"
 
@@ -35,6 +37,8 @@ namespace numlib{ namespace solver{
  *  NL... Nonlinear operator type
  *  K.... Krylov space type
  *  P.... Krylov projection operator type
+ *  G.... Gateaux (Jacobian-vector product) operator type; GateauxFD by
+ *        default, or GateauxAD for exact products
  *
  *  The design of this class deviates a bit from the NewtonKrylov class.  After
  *  some deliberation, it was decided that it would be easier, and
@@ -44,19 +48,34 @@ namespace numlib{ namespace solver{
  *  of the NewtonKrylov class interface that, in retrospect, make it awkward to
  *  use. For example, the NewtonKrylov class posses state (the residual vector),
  *  wherease this classes does not posses any state (only static parameters).
+ *
+ *  The solver does, however, own all of the work space used by an iteration
+ *  (Newton correction, linear residual, line search vectors, and the Krylov
+ *  basis). These are allocated once, at construction, and the accepted line
+ *  search result is handed back to the caller by swapping vectors rather than
+ *  copying them. Thus, the vectors passed to iter should be thought of as
+ *  being exchanged with solver owned vectors (of the same size) each
+ *  iteration; do not retain pointers to their elements across iterations.
+ *
+ *  When evaluating f is expensive, the line search may be instructed to
+ *  evaluate several candidate step lengths at once (see lineSearchCandidates).
+ *  The candidates are evaluated concurrently on the OpenMP thread team, each
+ *  with its own solution and residual vectors, and the best candidate which
+ *  satisfies the Goldstein-Armijo conditions is then selected. In this mode
+ *  f.eval must be safe to call concurrently from multiple threads.
  */
-template<class T, class NL, class K, class P>
+template<class T, class NL, class K, class P, class G = GateauxFD<T,NL> >
 class NewtonKrylovLB
 {
 public:
 
 	typedef linalg::Vector<T> VecType;
-	typedef Krylov<T,GateauxFD<T,NL>,K,P> KrylovSolver;
+	typedef Krylov<T,G,K,P> KrylovSolver;
 
 	//! Initializes solver
 	/*!
 	 *  Sets internal reference to the nonlinear operator f,
-	 *  and allocates internal memory required by algorithm.
+	 *  and allocates all internal memory required by algorithm.
 	 *
 	 *  Arguments:
 	 *    f: nonlinear operator
@@ -66,15 +85,38 @@ public:
 	 *    beta: slope scaling factor (lower limit)
 	 */
 	NewtonKrylovLB(NL& f_, Size n_, Size mmax_, T alpha_, T beta_, T lambda_min_):
-		f(f_),n(n_),mmax(mmax_),alpha(alpha_),beta(beta_),lambda_min(lambda_min_)
+		f(f_),n(n_),mmax(mmax_),alpha(alpha_),beta(beta_),lambda_min(lambda_min_),
+		ncand(1),lam(1),du(n_),rlin(n_),gateaux(f_,n_),krylov_solver(n_,mmax_),
+		conv_crit(f_,n_,alpha_,beta_,1),conv_hist()
 	{}
 
+	//! Sets the number of step lengths evaluated concurrently by the line search
+	/*!
+	 *  The default value, 1, results in the usual sequential line search.
+	 *  Larger values trade extra (concurrent) evaluations of f for fewer
+	 *  sequential line search stages.
+	 */
+	void lineSearchCandidates(Size k)
+	{
+		ASSERT( k > 0 );
+		if(k == ncand) return;
+		ncand = k;
+		lam.resize(k);
+		conv_crit.resize(k);
+	}
+
+	//! Returns the number of step lengths evaluated concurrently by the line search
+	Size lineSearchCandidates() const { return ncand; }
+
 	//! Executes a single iteration of the nonlinear solver
 	/*!
 	 *  Upon input, u should contain the current solution estimate, and r should
 	 *  be the corresponding (nonlinear) residual vector.  Upon output, u
 	 *  contains the updated solution estimate, and r contains the updated
 	 *  residual vector. (Remember, r = f(u).)
+	 *
+	 *  The updated u and r are returned by exchanging the contents of u and
+	 *  r with internal vectors (see class documentation).
 	 */
 	T iter(VecType& u, VecType& r)
 	{
@@ -82,10 +124,6 @@ public:
 		ASSERT( u.size() == n );
 		ASSERT( r.size() == n );
 
-		// Setup working variables...
-		VecType du(n); /* Newton correction vector */
-		VecType rlin(n); /* linear residual vector */
-
 		// Compute approximate newton correction vector...
 		newton_correction(r, u, du, rlin);
 
@@ -94,11 +132,11 @@ public:
 		const T fup = -2.0*fu - prod(r,rlin);
 
 		// Initialize convergence history...
-		ConvHist conv_hist;
+		conv_hist.clear();
 		conv_hist.append(0.0, fu);
 
 		// Initialize convergence criteria...
-		ConvCrit conv_crit(f, u, du, fu, fup, alpha, beta);
+		conv_crit.reset(u, du, fu, fup);
 
 		// Try full Newton step...
 		full_step_strategy(conv_crit, conv_hist);
@@ -112,18 +150,27 @@ public:
 			// Scale back by fitting a quadratic and finding its minimum...
 			// -- Remember, this will always reduce lambda.
 			DEBUG_PRINT("Applying min quad strategy");
-			min_quadratic_strategy(conv_crit, conv_hist, fu, fup);
+			if(ncand > 1)
+				min_quadratic_parallel_strategy(conv_crit, conv_hist, fu, fup);
+			else
+				min_quadratic_strategy(conv_crit, conv_hist, fu, fup);
 	    } else if(beta_failed){
 			/* If we're here, then Newton step is too small. */
 			// Scale up by doubling lambda...
 			DEBUG_PRINT("Applying doubling strategy");
-			doubling_strategy(conv_crit, conv_hist);
+			if(ncand > 1)
+				doubling_parallel_strategy(conv_crit, conv_hist);
+			else
+				doubling_strategy(conv_crit, conv_hist);
 		}
 
 		// Correct any overshoots, if any...
 		if(!conv_crit.both_satisfied()){
 			DEBUG_PRINT("Applying successive linear interp");
-			successive_linear_interp_strategy(conv_crit, conv_hist, fu, fup);
+			if(ncand > 1)
+				linear_interp_parallel_strategy(conv_crit, conv_hist, fu, fup);
+			else
+				successive_linear_interp_strategy(conv_crit, conv_hist, fu, fup);
 		}
 
 		// Let's be sure that criteria has been satisfied...
@@ -133,8 +180,7 @@ public:
 		
 		// Return result...
 		DEBUG_PRINT("Returning result");
-		u = conv_crit.soln_vector();
-		r = conv_crit.residual_vector();
+		conv_crit.swap_result(u, r);
 		return norm2(r);
 
 	} // iter
@@ -146,6 +192,13 @@ private:
 /*----------------------------------------------------------------------------*/
 /*                                                Helper classes and typedefs */
 
+	//! Line search history
+	/*!
+	 *  Only the entries required by the backtracking strategies (the first,
+	 *  second to last, and last) are retained, so appending never allocates.
+	 *  Every entry is also written to a log file, which is flushed once per
+	 *  Newton iteration (when the history is cleared).
+	 */
 	class ConvHist
 	{
 	public:
@@ -154,47 +207,60 @@ private:
 		{
 			T lambda;
 			T fu;
+			Elem():lambda(0),fu(0){}
 			Elem(T lambda_, T fu_):lambda(lambda_),fu(fu_){}
 		};
 
-		ConvHist():data(),log_file("newton_krylov_conv.log"){}
+		ConvHist():count(0),log_file("newton_krylov_conv.log"){}
 
 		~ConvHist()
 		{
 			log_file.close();
 		}
 
+		void clear()
+		{
+			count = 0;
+			log_file.flush();
+		}
+
 		ConvHist& append(const Elem& elem)
 		{
-			data.push_back(elem);
+			if(count == 0) head = elem;
+			prev = tail;
+			tail = elem;
+			++count;
 			return *this;
 		}
 
 		ConvHist& append(const T& lambda, const T& fu)
 		{
 			DEBUG_PRINT_VAR(lambda);
-			log_file<<lambda<<" "<<fu<<std::endl;
+			log_file<<lambda<<" "<<fu<<'\n';
 			return append(Elem(lambda,fu));
 		}
 		
 		const Elem& first() const
 		{
-			return data.front();
+			ASSERT( count > 0 );
+			return head;
 		}
 		
 		const Elem& last() const
 		{
-			return data.back();
+			ASSERT( count > 0 );
+			return tail;
 		}
 		
 		const Elem& second_last() const
 		{
-			return *(++(data.rbegin()));
+			ASSERT( count > 1 );
+			return prev;
 		}
 		
 	private:
-		typedef typename std::list< Elem > Data;
-		Data data;
+		Size count;
+		Elem head, prev, tail;
 		std::ofstream log_file;
 	};
 
@@ -203,49 +269,104 @@ private:
 	 *  The Goldstien-Armijo conditions consist of two inequalities
 	 *  that provide sufficient conditions for global convergence. These
 	 *  are also known as the alpha-beta conditions.
+	 *
+	 *  Several candidate step lengths may be checked at once. Each candidate
+	 *  has its own solution and residual vector; the accessors which take no
+	 *  candidate index refer to the currently selected candidate.
 	 */
 	class ConvCrit
 	{
 	public:
 
-		ConvCrit(NL& f_, 
-				 const VecType& u_, const VecType& du_, 
-				 const T& fu_, const T& fup_, 
-				 const T& alpha, const T& beta):
-			a(alpha),b(beta),fu(fu_),fup(fup_),
-			u(u_),du(du_),u_new(u_.size()),r_new(u_.size()),
+		ConvCrit(NL& f_, Size n_, const T& alpha, const T& beta, Size ncand=1):
+			alpha_check(false),beta_check(false),
+			a(alpha),b(beta),fu(0),fup(0),
+			u(0),du(0),n(n_),
+			fu_new(0),alpha_new(0),beta_new(0),
+			u_new(0),r_new(0),cur(0),
 			f(f_) 
 		{
+			resize(ncand);
+		}
+
+		//! Sets the number of candidates which may be checked at once
+		void resize(Size ncand)
+		{
+			fu_new.resize(ncand);
+			alpha_new.resize(ncand);
+			beta_new.resize(ncand);
+			u_new.resize(ncand);
+			r_new.resize(ncand);
+			for(Index k=0; k<ncand; ++k)
+			{
+				u_new(k).resize(n);
+				r_new(k).resize(n);
+				u_new(k).zero();
+				r_new(k).zero();
+			}
+			cur = 0;
+		}
+
+		//! Sets the line, u + lambda*du, and the reference objective values
+		/*!
+		 *  Only references to u and du are stored; these must remain valid,
+		 *  and unmodified, until the next call to reset.
+		 */
+		void reset(const VecType& u_, const VecType& du_, const T& fu_, const T& fup_)
+		{
+			ASSERT( u_.size() == n );
+			ASSERT( du_.size() == n );
+			u = &u_;
+			du = &du_;
+			fu = fu_;
+			fup = fup_;
+			cur = 0;
 			DEBUG_PRINT_VAR( fu );
 			DEBUG_PRINT_VAR( fup );
-			u_new.zero();
-			r_new.zero();
 		}
 
+		//! Checks a single step length; this becomes the selected candidate
 		bool check(const T& lam)
 		{
-			// Compute objective function...
-			u_new = du;
-			u_new *= lam;
-			u_new += u;
-			f.eval(u_new,r_new);
-			fu_new = 0.5*prod(r_new,r_new);
-
+			evaluate(0, lam);
 			DEBUG_PRINT_VAR( lam );
-			DEBUG_PRINT_VAR(fu_new);
+			DEBUG_PRINT_VAR( fu_new(0) );
+			select(0);
+			return alpha_check and beta_check;
+		}
 
-			// Check alpha condition (upper limit)...
-			alpha_check = !(fu_new > fu + a*lam*fup);
+		//! Concurrently checks the step lengths lam[0], ..., lam[k-1]
+		/*!
+		 *  No candidate is selected; use the candidate accessors to inspect
+		 *  the results, and select to choose one.
+		 */
+		void check(const T* lam, Size k)
+		{
+			ASSERT( k <= size() );
 
-			DEBUG_PRINT_VAR( alpha_check );
+			#pragma omp parallel for schedule(dynamic)
+			for(Index i=0; i<k; ++i)
+				evaluate(i, lam[i]);
 
-			// Check beta condition (lower limit)...
-			beta_check = !(fu_new < fu + b*lam*fup);
+			for(Index i=0; i<k; ++i)
+			{
+				DEBUG_PRINT_VAR( lam[i] );
+				DEBUG_PRINT_VAR( fu_new(i) );
+			}
+		}
 
-			DEBUG_PRINT_VAR( beta_check );
-			
-			// Return true if both conditions satisfied...
-			return alpha_check and beta_check;
+		//! Makes candidate k the current result
+		void select(Index k)
+		{
+			cur = k;
+			alpha_check = alpha_new(k);
+			beta_check = beta_new(k);
+		}
+
+		//! Returns the number of candidates which may be checked at once
+		Size size() const
+		{
+			return u_new.size();
 		}
 
 		const T& alpha() const 
@@ -275,27 +396,76 @@ private:
 		
 		const T& objective_function_value() const
 		{
-			return fu_new;
+			return fu_new(cur);
 		}
 		
 		const VecType& soln_vector() const
 		{
-			return u_new;
+			return u_new(cur);
 		}
 		
 		const VecType& residual_vector() const
 		{
-			return r_new;
+			return r_new(cur);
+		}
+
+		//! Exchanges the selected solution and residual vectors with u and r
+		void swap_result(VecType& u_, VecType& r_)
+		{
+			u_.swap(u_new(cur));
+			r_.swap(r_new(cur));
+		}
+
+		const T& candidate_objective_function_value(Index k) const
+		{
+			return fu_new(k);
+		}
+
+		const bool candidate_alpha_satisfied(Index k) const
+		{
+			return alpha_new(k);
+		}
+
+		const bool candidate_beta_satisfied(Index k) const
+		{
+			return beta_new(k);
 		}
 
 	private:
 
 		bool alpha_check, beta_check;
-		const T a, b, fu, fup;
-		const VecType u, du;
-		T fu_new;
-		VecType u_new, r_new;
+		const T a, b;
+		T fu, fup;
+		const VecType* u;
+		const VecType* du;
+		Size n;
+		array::Array1D<T> fu_new;
+		array::Array1D<bool> alpha_new, beta_new;
+		array::Array1D<VecType> u_new, r_new;
+		Index cur;
 		NL& f;
+
+		// Evaluates the objective function for candidate k
+		void evaluate(Index k, const T& lam)
+		{
+			VecType& uk = u_new(k);
+			VecType& rk = r_new(k);
+
+			// Compute objective function...
+			uk = *du;
+			uk *= lam;
+			uk += *u;
+			f.eval(uk,rk);
+			const T fuk = 0.5*prod(rk,rk);
+
+			fu_new(k) = fuk;
+
+			// Check alpha condition (upper limit)...
+			alpha_new(k) = !(fuk > fu + a*lam*fup);
+
+			// Check beta condition (lower limit)...
+			beta_new(k) = !(fuk < fu + b*lam*fup);
+		}
 				
 	};
 
@@ -307,6 +477,17 @@ private:
 	T alpha;
 	T beta;
 	T lambda_min;
+	Size ncand;         /* number of concurrent line search candidates */
+
+/*----------------------------------------------------------------------------*/
+/*                                                                 Work space */
+	array::Array1D<T> lam;        /* line search candidates */
+	VecType du;                   /* Newton correction vector */
+	VecType rlin;                 /* linear residual vector */
+	G gateaux;                    /* Jacobian-vector product operator */
+	KrylovSolver krylov_solver;
+	ConvCrit conv_crit;
+	ConvHist conv_hist;
 
 /*----------------------------------------------------------------------------*/
 /*                                                           Helper functions */
@@ -314,11 +495,8 @@ private:
 	// Computes the newton correction vector 'du'
 	void newton_correction(const VecType& r, const VecType& u, VecType& du, VecType& rlin)
 	{
-		// Setup finite difference operator...
-		GateauxFD<T,NL> gateaux(f, u, r);
-
-		// Setup Krylov solver...
-		KrylovSolver krylov_solver(n,mmax);
+		// Linearize about u (u and r are referenced, not copied)...
+		gateaux.bind(u, r);
 
 		// Set tolerance used to determine "happy breakdown"...
 		const T breakdown_tol=0.5E-6;
@@ -439,6 +617,141 @@ private:
 		}
 	}
 		
+	/*------------------------------------------------------------------------
+	 * Multi-candidate variants of the above strategies. Each stage evaluates
+	 * up to ncand step lengths concurrently, then appends the evaluated
+	 * candidates to the convergence history; the selected candidate is
+	 * always appended last. The doubling and min quadratic variants visit
+	 * candidates in the order of the sequential strategy and stop at the
+	 * selected candidate; the linear interp variant appends the remaining
+	 * candidates of its final stage ahead of the selected one.
+	 *
+	 * NOTE: The min quadratic variant does not reproduce the steps of the
+	 * sequential strategy. The sequential strategy clamps the minimum of the
+	 * quadratic model with min(lambda_min, lambda), i.e. from above, so its
+	 * first (and usually only) step is at most lambda_min, and the linear
+	 * interp strategy then searches the bracket [lambda_min, 1]. The
+	 * multi-candidate variant instead floors its candidates at lambda_min,
+	 * and successively halves the minimum of the model down to that floor;
+	 * thus, lineSearchCandidates(1) and lineSearchCandidates(k), k > 1, may
+	 * select different steps on the same problem.
+	 *------------------------------------------------------------------------*/
+
+	void doubling_parallel_strategy(ConvCrit& conv_crit, ConvHist& conv_hist)
+	{
+		T lambda = conv_hist.last().lambda;
+		while(true){
+			for(Index k=0; k<ncand; ++k){
+				lambda *= 2.0;
+				lam(k) = lambda;
+			}
+			conv_crit.check(&lam(0), ncand);
+			for(Index k=0; k<ncand; ++k){
+				conv_crit.select(k);
+				conv_hist.append(lam(k), conv_crit.objective_function_value());
+				if(conv_crit.beta_satisfied()) return;
+			}
+		}
+	}
+
+	void min_quadratic_parallel_strategy(ConvCrit& conv_crit, ConvHist& conv_hist,
+										 const T& fu0, const T& fup0)
+	{
+		// Minimum of quadratic model, followed by successive halvings...
+		T lambda = conv_hist.last().lambda;
+		T fu = conv_hist.last().fu;
+		lambda = -0.5*fup0*lambda*lambda/(fu - fu0 - fup0*lambda);
+		while(true){
+			// Candidates are clamped at lambda_min, which ends the sequence...
+			Size nc = 0;
+			while(nc < ncand){
+				lam(nc) = numlib::max(lambda_min, lambda);
+				lambda = 0.5*lam(nc);
+				if(not (lam(nc++) > lambda_min)) break;
+			}
+			conv_crit.check(&lam(0), nc);
+
+			// Select the largest candidate satisfying the alpha condition...
+			for(Index k=0; k<nc; ++k){
+				conv_crit.select(k);
+				conv_hist.append(lam(k), conv_crit.objective_function_value());
+				if(conv_crit.alpha_satisfied()) return;
+			}
+			if(not (lam(nc-1) > lambda_min)) return;
+		}
+	}
+
+	void linear_interp_parallel_strategy(ConvCrit& conv_crit, ConvHist& conv_hist,
+										 const T& fu0, const T& fup0)
+	{
+		// Find lambda low and high (see successive_linear_interp_strategy)...
+		T lambda_hi, fu_hi;
+		T lambda_low, fu_low;
+		if(conv_hist.last().lambda > 1){
+			lambda_hi = conv_hist.last().lambda;
+			fu_hi = conv_hist.last().fu;
+			lambda_low = conv_hist.second_last().lambda;
+			fu_low = conv_hist.second_last().fu;
+		} else {
+			lambda_low = conv_hist.last().lambda;
+			fu_low = conv_hist.last().fu;
+			lambda_hi = conv_hist.second_last().lambda;
+			fu_hi = conv_hist.second_last().fu;
+		}
+
+		const T alpha = conv_crit.alpha();
+		while(true){
+			// Interpolated lambda plus uniformly spaced points of the bracket...
+			const T m = (fu_hi - fu_low)/(lambda_hi - lambda_low);
+			const T den = m - alpha*fup0;
+			if(numlib::is_zero(den))
+				throw numlib::NumLibError("Division by zero in NewtonKrylovLB linear interp");
+			lam(0) = (fu0 - fu_low + m*lambda_low)/den;
+			for(Index k=1; k<ncand; ++k)
+				lam(k) = lambda_low + (lambda_hi - lambda_low)*T(k)/T(ncand);
+			conv_crit.check(&lam(0), ncand);
+
+			// Select candidate satisfying both conditions with least objective...
+			Index best = ncand;
+			for(Index k=0; k<ncand; ++k){
+				if(conv_crit.candidate_alpha_satisfied(k) and
+				   conv_crit.candidate_beta_satisfied(k)){
+					if( (best == ncand) or
+						(conv_crit.candidate_objective_function_value(k) <
+						 conv_crit.candidate_objective_function_value(best)) )
+						best = k;
+				}
+			}
+			if(best < ncand){
+				for(Index k=0; k<ncand; ++k)
+					if(k != best)
+						conv_hist.append(lam(k), conv_crit.candidate_objective_function_value(k));
+				conv_hist.append(lam(best), conv_crit.candidate_objective_function_value(best));
+				conv_crit.select(best);
+				return;
+			}
+
+			// Otherwise, tighten the bracket...
+			for(Index k=0; k<ncand; ++k){
+				const T fu = conv_crit.candidate_objective_function_value(k);
+				conv_hist.append(lam(k), fu);
+				if(conv_crit.candidate_alpha_satisfied(k)){
+					/* too small */
+					if(lam(k) > lambda_low){
+						lambda_low = lam(k);
+						fu_low = fu;
+					}
+				} else {
+					/* too big */
+					if(lam(k) < lambda_hi){
+						lambda_hi = lam(k);
+						fu_hi = fu;
+					}
+				}
+			}
+		}
+	}
+		
 }; // class NewtonKrylovLB
 
 }}//::numlib::solver
@@ -0,0 +1,88 @@
+/*! \file PreconditionedOperator.h
+ */
+
+#ifndef PRECONDITIONEDOPERATOR_H
+#define PRECONDITIONEDOPERATOR_H
+
+#include "../base/nocopy.h"
+#include "../linalg/Vector.h"
+#include "../linalg/LinearOperator.h"
+
+namespace numlib{ namespace solver{
+
+//! Right preconditioned linear operator, A*M^{-1}
+/*!
+ *  Wraps linear operator A and preconditioner M, so that the Krylov solvers
+ *  may be applied to the right preconditioned system
+ *
+ *     A*M^{-1}*y = b,  x = M^{-1}*y
+ *
+ *  which has the same residual as the original system, A*x = b. Thus, the
+ *  Krylov solver is given this operator in place of A, and the solution of
+ *  the original system is recovered from the Krylov solution y by calling
+ *  precondition(y, x).
+ *
+ *  The linear operator type, L, is any linear operator (see LinearOperator.h).
+ *  The preconditioner type, M, implements M.apply(r, z), which sets
+ *  z = M^{-1}*r (e.g. GeometricMultigrid).
+ */
+template<class T, class L, class M>
+class PreconditionedOperator
+{
+public:
+
+	 typedef linalg::Vector<T> VecType;
+
+	 PreconditionedOperator(const L & a_, M & m_, Size n):
+	    a(a_), m(m_), z(n)
+     { }
+
+	 ~PreconditionedOperator() { /* nothing to delete */ }
+
+	 //! Computes x = M^{-1}*y
+	 void precondition(const VecType & y, VecType & x) const
+     {
+         m.apply(y, x);
+     }
+
+	 //! Computes v = A*M^{-1}*u
+	 void eval(const VecType & u, VecType & v) const
+     {
+         m.apply(u, z);
+         prodIP(a, z, v);
+     }
+
+private:
+
+	 DISALLOW_COPY_AND_ASSIGN( PreconditionedOperator );
+
+	 //! Linear operator
+	 const L & a;
+
+	 //! Preconditioner
+	 M & m;
+
+	 //! Work vector holding M^{-1}*u
+	 mutable VecType z;
+
+};
+
+//! Linear operator wrapper function for PreconditionedOperator
+template<class T, class L, class M> inline
+linalg::Vector<T> prod(const PreconditionedOperator<T,L,M> & op, const linalg::Vector<T> & u)
+{
+	 linalg::Vector<T> v(u.size());
+	 op.eval(u, v);
+	 return v;
+}
+
+//! In-place linear operator wrapper function for PreconditionedOperator
+template<class T, class L, class M> inline
+void prodIP(const PreconditionedOperator<T,L,M> & op, const linalg::Vector<T> & u, linalg::Vector<T> & v)
+{
+	 op.eval(u, v);
+}
+
+}}//::numlib::solver
+
+#endif
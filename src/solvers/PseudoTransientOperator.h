@@ -4,19 +4,21 @@
 #ifndef PSEUDOTRANSIENTOPERATOR_H
 #define PSEUDOTRANSIENTOPERATOR_H
 
+#include <cmath>
 #include "../base/nocopy.h"
+#include "../base/debug_tools.h"
 #include "../linalg/Vector.h"
+#include "../linalg/VectorExpressions.h"
 
 namespace numlib{ namespace solver{
 
 //! Pseudo-transient continuation operator for solving nonlinear algebraic systems
 /*!
  *  This converts the problem of solving F(u) = 0 into the pseudo-transient problem
- *  du/dt - F(u) = 0, which has F(u) = 0 as its steady solution. The 
- *  pseudo-transient term du/dt is implicitly discretized using BDF2 (Euler Implicit
- *  for the first step). 
+ *  F(u) - du/dt = 0, which has F(u) = 0 as its steady solution. The 
+ *  pseudo-transient term du/dt is implicitly discretized using Euler Implicit.
  *
- *  The pseudo transient residual, R(u) = du/dt - F(u), may be reduced to zero at 
+ *  The pseudo transient residual, R(u) = F(u) - du/dt, may be reduced to zero at 
  *  each pseudo time step using a quasi-Newton method (e.g. NewtonKrylov). In 
  *  some cases the pseudo-transient residual need not be tightly converged at 
  *  each pseudo time step for the overall scheme to converge to F(u) = 0; e.g. 
@@ -34,6 +36,30 @@ namespace numlib{ namespace solver{
  *  Newton's method is being used it is possible that the Jacobian of F(u) will 
  *  become either singular or ill-conditioned (even for a "good" initial guess). 
  *  Use of pseudo-transient continuation will help to ensure that the Jacobian
+ *  remains well conditioned.
+ *
+ *  Optionally, the pseudo time step size may be adapted at each pseudo time
+ *  level using switched evolution relaxation (SER; Mulder, W.A., and B. van
+ *  Leer. "Experiments with Implicit Upwind Methods for the Euler Equations."
+ *  J. Comput. Phys. Vol. 59, pp. 232-246, 1985); i.e.
+ *
+ *     dtau_{k+1} = dtau_k*(||F(u_{k-1})||/||F(u_k)||)^p
+ *
+ *  where the change per level is limited to a factor of the growth limit
+ *  (and its reciprocal), and dtau is bounded by [dtau_min, dtau_max]. This
+ *  allows a small initial step, suitable for a poor initial guess, to grow
+ *  rapidly as the steady state is approached. If the steady residual grows
+ *  by more than the rejection ratio (or is not finite) the new time level is
+ *  rejected: the step size is reduced by the shrink factor, and the caller
+ *  is expected to restore the previous time level (see stepRejected and
+ *  restoreTimeLevel) before repeating the pseudo time step.
+ *
+ *  For stiff or multi-scale problems, a local (per-unknown) pseudo time step,
+ *  dtau_i = dtau*s_i, may be used instead (see localStepScaling). The scaling,
+ *  s, may be supplied directly, or estimated from the diagonal of the
+ *  Jacobian of F (e.g. from SparseJacobianFD and diagonal()) as s_i =
+ *  1/|dF_i/du_i|, in which case dtau plays the role of a CFL number. Step
+ *  size adaptation then acts on dtau (i.e. the CFL number).
  *
  *  The nonlinear operator F, is expected to be implemented in the same manner as 
  *  outlined in the NewtonKrylov documentation. The class which implements F, is 
@@ -50,16 +76,28 @@ public:
 	 PseudoTransientOperator(Size n, NL & f_):
 	    dtau(1.0),        /* Default pseudo time step size */
 	    tscale(1.0/dtau), /* initialize to time scaling to Implicit Euler */
+	    adaptive(false),
+	    dtau_min(0.0),
+	    dtau_max(1.0E12),
+	    ser_exp(1.0),
+	    growth_limit(10.0),
+	    shrink_factor(0.25),
+	    reject_ratio(10.0),
+	    rn_prev(0.0),
+	    rejected(false),
+	    local(false),
 	    uk(n),
-	    w(n),
+	    scale(n),
+	    tscale_local(n),
 	    r_steady(n),
 	    f(f_)
     {
     	 // Set default initial condition to zero...
     
     	 uk.zero();
-    	 w.zero();
     	 r_steady.zero();
+    	 for(Index i=0; i<n; ++i)
+    		 scale(i) = 1.0;
     
     	 DEBUG_PRINT_VAR( dtau );
     	 DEBUG_PRINT_VAR( tscale );
@@ -68,11 +106,120 @@ public:
 	 ~PseudoTransientOperator() { /* nothing to delete */ }
 
 	 //! Sets pseudo time step size
-	 void stepSize(Real dtau_) { dtau = dtau_; }
+	 void stepSize(Real dtau_) 
+     { 
+         ASSERT( dtau_ > 0.0 );
+         dtau = dtau_; 
+         tscale = 1.0/dtau;
+         if(local) updateLocalTimeScale();
+     }
 
 	 //! Returns pseudo time step size
 	 Real stepSize() const { return dtau; }
 
+	 //! Enables/disables SER adaptation of the pseudo time step size
+	 void adaptiveStepSize(bool flag) { adaptive = flag; }
+
+	 //! Returns true if the pseudo time step size is adapted
+	 bool adaptiveStepSize() const { return adaptive; }
+
+	 //! Sets bounds on the (adapted) pseudo time step size
+	 void stepSizeBounds(Real dtau_min_, Real dtau_max_)
+     {
+         ASSERT( dtau_min_ >= 0.0 );
+         ASSERT( dtau_min_ <= dtau_max_ );
+         dtau_min = dtau_min_;
+         dtau_max = dtau_max_;
+     }
+
+	 //! Returns lower bound of the (adapted) pseudo time step size
+	 Real minStepSize() const { return dtau_min; }
+
+	 //! Returns upper bound of the (adapted) pseudo time step size
+	 Real maxStepSize() const { return dtau_max; }
+
+	 //! Sets SER exponent, p
+	 void serExponent(Real p) { ser_exp = p; }
+
+	 //! Returns SER exponent, p
+	 Real serExponent() const { return ser_exp; }
+
+	 //! Sets the maximum factor by which dtau may change per accepted level
+	 void stepGrowthLimit(Real c) { ASSERT( c >= 1.0 ); growth_limit = c; }
+
+	 //! Returns the maximum factor by which dtau may change per accepted level
+	 Real stepGrowthLimit() const { return growth_limit; }
+
+	 //! Sets the factor by which dtau is reduced when a level is rejected
+	 void stepShrinkFactor(Real c) { ASSERT( c > 0.0 and c < 1.0 ); shrink_factor = c; }
+
+	 //! Returns the factor by which dtau is reduced when a level is rejected
+	 Real stepShrinkFactor() const { return shrink_factor; }
+
+	 //! Sets steady residual growth (per level) which causes a rejection
+	 void rejectionRatio(Real c) { ASSERT( c >= 1.0 ); reject_ratio = c; }
+
+	 //! Returns steady residual growth (per level) which causes a rejection
+	 Real rejectionRatio() const { return reject_ratio; }
+
+	 //! Sets the local pseudo time step scaling, dtau_i = dtau*s_i
+	 /*!
+	  *  The scaling is retained (and local time stepping remains in effect)
+	  *  until replaced, or until globalStepSize is called. Problems whose
+	  *  stiffness changes as the solution evolves should update the scaling
+	  *  at each pseudo time level (e.g. after calling nextTimeLevel).
+	  */
+	 void localStepScaling(const VecType & s)
+     {
+         ASSERT( s.size() == scale.size() );
+         scale = s;
+         local = true;
+         updateLocalTimeScale();
+     }
+
+	 //! Sets the local pseudo time step scaling from the Jacobian diagonal
+	 /*!
+	  *  Sets s_i = 1/|jdiag_i|, where jdiag is the diagonal of the Jacobian
+	  *  of F. Diagonal elements which are (near) zero relative to the largest
+	  *  are limited, so that s remains bounded.
+	  */
+	 void localStepScalingFromDiagonal(const VecType & jdiag)
+     {
+         ASSERT( jdiag.size() == scale.size() );
+
+         Real dmax(0);
+         for(Index i=0; i<jdiag.size(); ++i)
+             dmax = max(dmax, Real(std::fabs(jdiag(i))));
+
+         ASSERT( dmax > 0.0 );
+
+         const Real dmin = 1.0E-12*dmax;
+         for(Index i=0; i<jdiag.size(); ++i)
+             scale(i) = 1.0/max(Real(std::fabs(jdiag(i))), dmin);
+
+         local = true;
+         updateLocalTimeScale();
+     }
+
+	 //! Returns the local pseudo time step scaling
+	 const VecType & localStepScaling() const { return scale; }
+
+	 //! Returns true if local pseudo time stepping is in effect
+	 bool localStepSize() const { return local; }
+
+	 //! Reverts to a single (global) pseudo time step size for all unknowns
+	 void globalStepSize() { local = false; }
+
+	 //! Returns true if the last call to nextTimeLevel rejected the new level
+	 bool stepRejected() const { return rejected; }
+
+	 //! Resets u to the solution of the current (accepted) pseudo time level
+	 /*!
+	  *  Intended to be called after a rejected time level, before the pseudo
+	  *  time step is repeated with the reduced step size.
+	  */
+	 void restoreTimeLevel(VecType & u) const { u = uk; }
+
 	 //! Sets initial conditions for pseudo march to steady state
 	 /*!
 	  *  This should be set to the initial solution estimate which would
@@ -86,8 +233,9 @@ public:
      	 ASSERT(dtau > 0.0);
      	 tscale = 1.0/dtau;
      
-     	 // Reset work vector...
-     	 w.zero();
+     	 // Reset step size control...
+     	 rn_prev = 0.0;
+     	 rejected = false;
      
      	 // Set reference solution...
      	 uk = u0;
@@ -100,31 +248,72 @@ public:
 	  *  will be used as the "previous" solution corresponding to the 
 	  *  k pseudo time level.
 	  *
-	  *  The 2-norm of the steady residual, F(u), is computed from the
-	  *  change in the solution and is returned as an rvalue.
+	  *  The 2-norm of the steady residual, F(u), is returned as an rvalue.
+	  *  F(u) is taken from the most recent evaluation of this operator,
+	  *  which is expected to have been at u.
 	  *
+	  *  If the step size is adapted, the step size for the next level is
+	  *  updated here. If the new level is rejected (see stepRejected) the
+	  *  time level is not advanced.
 	  */
 	 Real nextTimeLevel(const VecType & u)
      {
      	 ASSERT( dtau > 0.0 );
 
      	 DEBUG_PRINT_VAR( dtau );
+
+     	 const Real rn = norm2( r_steady );
+
+     	 rejected = false;
+
+     	 if(adaptive)
+     	 {
+     		 if( !(rn == rn) or (rn_prev > 0.0 and rn > reject_ratio*rn_prev) )
+     		 {
+     			 // Reject level (retain reference solution)...
+     			 DEBUG_PRINT( "Rejecting pseudo time level" );
+     			 rejected = true;
+     			 stepSize( max(shrink_factor*dtau, dtau_min) );
+     			 return rn;
+     		 }
+
+     		 if(rn_prev > 0.0 and rn > 0.0)
+     		 {
+     			 Real c = std::pow(rn_prev/rn, ser_exp);
+     			 c = min(max(c, 1.0/growth_limit), growth_limit);
+     			 stepSize( min(max(c*dtau, dtau_min), dtau_max) );
+     		 }
+
+     		 rn_prev = rn;
+     	 }
           
      	 // Pivot reference solution...
      	 uk = u;
     
          // Return norm... 
-     	 return norm2( r_steady );
+     	 return rn;
      }
 
-	 //! Evaluates the pseudo-transient residual, r = d(u)/dt - F(u)
+	 //! Evaluates the pseudo-transient residual, r = F(u) - d(u)/dt
 	 void eval(const VecType & u, VecType & r)
      {
+     	 ASSERT( u.size() == uk.size() );
+     	 ASSERT( r.size() == uk.size() );
+
      	 // Evaluate F(u)...
      	 f.eval(u, r_steady);
      
      	 // Add contribution from pseudo transient ...
-     	 r = r_steady - (u - uk)/dtau;
+     	 if(local)
+     	 {
+     		 for(Index i=0; i<u.size(); ++i)
+     			 r(i) = r_steady(i) - tscale_local(i)*(u(i) - uk(i));
+     	 }
+     	 else
+     	 {
+     		 for(Index i=0; i<u.size(); ++i)
+     			 r(i) = r_steady(i) - tscale*(u(i) - uk(i));
+     	 }
      
      	 DEBUG_PRINT("Writting u, r, r_steady to log files...");
      	 DEBUG_LOG("pseudo_tran_res_operator-u.dat", u);
@@ -139,14 +328,47 @@ private:
 	 //! Pseudo time step size
 	 Real dtau;
 
-	 //! Pseudo time scale factor
+	 //! Pseudo time scale factor (1/dtau)
 	 Real tscale;
 
+	 //! Step size adaptation flag
+	 bool adaptive;
+
+	 //! Lower bound of the adapted step size
+	 Real dtau_min;
+
+	 //! Upper bound of the adapted step size
+	 Real dtau_max;
+
+	 //! SER exponent
+	 Real ser_exp;
+
+	 //! Maximum change of step size per accepted level
+	 Real growth_limit;
+
+	 //! Step size reduction upon rejection
+	 Real shrink_factor;
+
+	 //! Steady residual growth causing rejection
+	 Real reject_ratio;
+
+	 //! Steady residual norm of the previous accepted level
+	 Real rn_prev;
+
+	 //! Rejection flag for the last level
+	 bool rejected;
+
+	 //! Local time stepping flag
+	 bool local;
+
 	 //! Solution corresponding to the kth pseudo time level
 	 VecType uk;
 
-	 //! Working vector associated with the difference between k and k-1 time levels
-	 VecType w;
+	 //! Local pseudo time step scaling, s
+	 VecType scale;
+
+	 //! Local pseudo time scale factors, 1/(dtau*s_i)
+	 VecType tscale_local;
 
 	 //! Steady residual vector
 	 VecType r_steady;
@@ -154,6 +376,16 @@ private:
 	 //! Reference to nonlinear operator class which implements F(u).
 	 NL & f;
 
+	 // Updates the local time scale factors from dtau and s
+	 void updateLocalTimeScale()
+     {
+         for(Index i=0; i<scale.size(); ++i)
+         {
+             ASSERT( scale(i) > 0.0 );
+             tscale_local(i) = tscale/scale(i);
+         }
+     }
+
 };
 
 }}//::numlib::solver
@@ -0,0 +1,257 @@
+/*! \file SparseJacobianFD.h
+ */
+
+#ifndef SPARSEJACOBIANFD_H
+#define SPARSEJACOBIANFD_H
+
+#include <cmath>
+#include "../base/nocopy.h"
+#include "../base/debug_tools.h"
+#include "../base/numlib-config.h"
+#include "../array/Array1D.h"
+#include "../linalg/Vector.h"
+#include "../linalg/SparseMatrix.h"
+
+namespace numlib{ namespace solver{
+
+//! Finite difference assembly of a sparse Jacobian matrix
+/*!
+ *  Assembles the Jacobian of F:R^N -> R^N, with known sparsity pattern, by
+ *  forward differences. Columns which do not share a non-zero row (i.e.
+ *  structurally orthogonal columns) are assigned the same color, and are
+ *  perturbed simultaneously; thus, the full Jacobian is assembled with one
+ *  evaluation of f per color (Curtis, A.R., M.J.D. Powell, and J.K. Reid.
+ *  "On the Estimation of Sparse Jacobian Matrices." IMA J. Appl. Math.
+ *  Vol. 13, pp. 117-119, 1974). The coloring is a greedy distance-2
+ *  coloring of the column adjacency graph, computed once at construction.
+ *  For stencil operators the number of colors is independent of N, and is
+ *  comparable to the number of stencil points (e.g. 7 colors for the 5
+ *  point stencil in natural ordering), rather than N evaluations.
+ *
+ *  The nonlinear operator, f, implements the same interface as for
+ *  GateauxFD; i.e. f.eval(u, r). The assembled Jacobian is stored in a
+ *  SparseMatrix, which may then be used as an explicit linear operator
+ *  (see SparseMatrixExpressions.h).
+ */
+template<class T, class NL>
+class SparseJacobianFD
+{
+public:
+
+	typedef linalg::Vector<T> VecType;
+
+	typedef linalg::SparseMatrix<T> MatType;
+
+	//! Computes a column coloring for the sparsity pattern of J
+	/*!
+	 *  Only the pattern of J is used (values are ignored).
+	 */
+	SparseJacobianFD(const MatType& J):
+		eps(1.0E-9), n(J.size1()), nz(J.nnz()), ncolors(0),
+		colPtr(J.size2()+1), rowIdx(J.nnz()), pos(J.nnz()),
+		color(J.size2()), colorPtr(0), colorCol(J.size2()),
+		upert(J.size2()), fpert(J.size1())
+	{
+		ASSERT( J.size1() == J.size2() );
+
+		eps = std::sqrt(eps);
+
+		transposePattern(J);
+		colorColumns(J);
+
+		DEBUG_PRINT_VAR( ncolors );
+	}
+
+	~SparseJacobianFD() { /* nothing to delete */ }
+
+	//! Returns the number of colors (evaluations of f per assembly)
+	Size colors() const { return ncolors; }
+
+	//! Returns the color of column j
+	Index columnColor(Index j) const { return color(j); }
+
+	//! Assembles the Jacobian of f at u
+	/*!
+	 *  Arguments:
+	 *  f := Nonlinear operator to be differentiated
+	 *  u := Vector at which the Jacobian is evaluated
+	 *  fu := Value of f(u)
+	 *  J := Jacobian; must have the sparsity pattern used at construction
+	 *
+	 *  Note: fu is passed as an input argument since most applications
+	 *  will have already evaluted f(u) (e.g. as the residual of some
+	 *  discrete operator).
+	 */
+	void assemble(NL& f, const VecType& u, const VecType& fu, MatType& J)
+	{
+		ASSERT( u.size() == n );
+		ASSERT( fu.size() == n );
+		ASSERT( J.size1() == n );
+		ASSERT( J.nnz() == nz );
+
+		upert = u;
+
+		for(Index c=0; c<ncolors; ++c)
+		{
+			// Perturb all columns of color c...
+
+			for(Index p=colorPtr(c); p<colorPtr(c+1); ++p)
+			{
+				Index j = colorCol(p);
+				T h = eps*max(std::fabs(u(j)), T(1));
+				if(u(j) < 0) h = -h;
+				upert(j) = u(j) + h;
+			}
+
+			f.eval(upert, fpert); /* fpert = f(u + sum h_j*e_j) */
+
+			// Scatter differences into the Jacobian...
+
+			for(Index p=colorPtr(c); p<colorPtr(c+1); ++p)
+			{
+				Index j = colorCol(p);
+				T h = upert(j) - u(j); /* exactly representable step */
+				for(Index q=colPtr(j); q<colPtr(j+1); ++q)
+				{
+					Index i = rowIdx(q);
+					J.value(pos(q)) = (fpert(i) - fu(i))/h;
+				}
+				upert(j) = u(j);
+			}
+		}
+	}
+
+private:
+
+	DISALLOW_COPY_AND_ASSIGN( SparseJacobianFD );
+
+	typedef array::Array1D<Index> IndexArray;
+
+	//! Relative perturbation size
+	Real eps;
+
+	//! Rank of f
+	Size n;
+
+	//! Number of non-zeros in the sparsity pattern
+	Size nz;
+
+	//! Number of colors
+	Size ncolors;
+
+	//! Start of each column in rowIdx (column compressed pattern)
+	IndexArray colPtr;
+
+	//! Row index of each non-zero (column compressed pattern)
+	IndexArray rowIdx;
+
+	//! Position of each non-zero in the row compressed pattern
+	IndexArray pos;
+
+	//! Color of each column
+	IndexArray color;
+
+	//! Start of each color in colorCol
+	IndexArray colorPtr;
+
+	//! Columns grouped by color
+	IndexArray colorCol;
+
+	//! Work vector holding the perturbed solution
+	VecType upert;
+
+	//! Work vector holding f at the perturbed solution
+	VecType fpert;
+
+	/*------------------------------------------------------------------------*/
+	/* Helper functions */
+
+	// Builds the column compressed pattern of J
+	void transposePattern(const MatType& J)
+	{
+		const Size m = J.size2();
+
+		for(Index j=0; j<=m; ++j)
+			colPtr(j) = 0;
+
+		for(Index k=0; k<nz; ++k)
+			++colPtr(J.column(k)+1);
+
+		for(Index j=0; j<m; ++j)
+			colPtr(j+1) += colPtr(j);
+
+		IndexArray next(m);
+		for(Index j=0; j<m; ++j)
+			next(j) = colPtr(j);
+
+		for(Index i=0; i<n; ++i)
+		{
+			for(Index k=J.rowBegin(i); k<J.rowEnd(i); ++k)
+			{
+				Index q = next(J.column(k))++;
+				rowIdx(q) = i;
+				pos(q) = k;
+			}
+		}
+	}
+
+	// Greedy distance-2 coloring of the columns of J
+	/*!
+	 *  Columns j and k conflict if a row has non-zeros in both columns.
+	 *  Each column is assigned the smallest color not used by any
+	 *  (previously colored) conflicting column.
+	 */
+	void colorColumns(const MatType& J)
+	{
+		const Size m = J.size2();
+
+		// forbidden(c) == j+1 marks color c as forbidden for column j
+		IndexArray forbidden(m+1);
+		for(Index c=0; c<=m; ++c)
+			forbidden(c) = 0;
+
+		ncolors = 0;
+		for(Index j=0; j<m; ++j)
+		{
+			for(Index q=colPtr(j); q<colPtr(j+1); ++q)
+			{
+				Index i = rowIdx(q);
+				for(Index k=J.rowBegin(i); k<J.rowEnd(i); ++k)
+				{
+					Index jk = J.column(k);
+					if(jk < j)
+						forbidden(color(jk)) = j+1;
+				}
+			}
+
+			Index c = 0;
+			while(forbidden(c) == j+1) ++c;
+			color(j) = c;
+			ncolors = max(ncolors, c+1);
+		}
+
+		// Group columns by color...
+
+		colorPtr.resize(ncolors+1);
+		for(Index c=0; c<=ncolors; ++c)
+			colorPtr(c) = 0;
+
+		for(Index j=0; j<m; ++j)
+			++colorPtr(color(j)+1);
+
+		for(Index c=0; c<ncolors; ++c)
+			colorPtr(c+1) += colorPtr(c);
+
+		IndexArray next(ncolors);
+		for(Index c=0; c<ncolors; ++c)
+			next(c) = colorPtr(c);
+
+		for(Index j=0; j<m; ++j)
+			colorCol(next(color(j))++) = j;
+	}
+
+};
+
+}}//::numlib::solver
+
+#endif